@@ -8,12 +8,14 @@
  */
 
 // includes
-#include "includes/bios.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/memory.h"
 
-// init vars
-const char *Bios::filename = NULL;
+// responsible for constructing the bios
+Bios::Bios(GameBoy &gb) : gb(gb), filename(NULL)
+{
+
+}
 
 // responsible for loading the bios
 bool Bios::Load(const char *filePath)
@@ -26,16 +28,15 @@ bool Bios::Load(const char *filePath)
 		result = true;
 		filename = filePath;
 
-		fread(&Memory::mem, 1, 0x100, biosRom);
+		fread(&gb.memory.mem, 1, 0x100, biosRom);
 		Log::Print("Loaded bios '%s' successfully", filePath);
+		fclose(biosRom);
 	}
 	else
 	{
 		Log::Critical("Failed to load bios at filepath: '%s'", filePath);
 	}
 
-	fclose(biosRom);
-
 	return result;
 }
 
@@ -0,0 +1,251 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include <string.h>
+#include "includes/blockCache.h"
+#include "includes/gameboy.h"
+
+// definitions
+#define REGION_ROM0 0
+#define REGION_WRAM 1
+#define REGION_ROMX 2
+#define BLOCK_NONE -1
+#define BLOCK_UNCACHEABLE -2
+
+// init vars
+// the length of each opcode (including its immediate), as the cpu steps over it (0 = unused opcode)
+const u8 BlockCache::opcodeLength[256] =
+{
+	1, 3, 1, 1, 1, 1, 2, 1, 3, 1, 1, 1, 1, 1, 2, 1, // 00
+	1, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 10
+	2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 20
+	2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 30
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 40
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 50
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 60
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 70
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 80
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 90
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // A0
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // B0
+	1, 1, 3, 3, 3, 1, 2, 1, 1, 1, 3, 2, 3, 3, 2, 1, // C0
+	1, 1, 3, 0, 3, 1, 2, 1, 1, 1, 3, 0, 3, 0, 2, 1, // D0
+	2, 1, 1, 0, 0, 1, 2, 1, 2, 1, 3, 0, 0, 0, 2, 1, // E0
+	2, 1, 1, 1, 0, 1, 2, 1, 2, 1, 3, 1, 0, 0, 2, 1, // F0
+};
+
+// the opcode pairs that get fused, indexed by id - 1
+static const u8 fusedPairs[][2] =
+{
+	#define FUSED(id, first, second) {first, second},
+	#include "includes/opcodesFused.h"
+	#undef FUSED
+};
+
+// responsible for determining if an opcode can change the flow of execution
+static bool EndsBlock(u8 opcode)
+{
+	switch(opcode)
+	{
+		case 0x10: case 0x76: // STOP, HALT
+		case 0x18: case 0x20: case 0x28: case 0x30: case 0x38: // JR
+		case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: case 0xE9: // JP
+		case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC: // CALL
+		case 0xC0: case 0xC8: case 0xC9: case 0xD0: case 0xD8: case 0xD9: // RET, RETI
+		case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF: // RST
+			return true;
+		default: return false;
+	}
+}
+
+// responsible for determining if a polling loop reads the given register (it only changes when the timer or lcd runs an event)
+static bool IsPolledRegister(u16 address)
+{
+	return (address == Memory::Address::IF || address == Memory::Address::STAT || address == Memory::Address::LY);
+}
+
+// responsible for determining if an opcode only changes A and the flags, and reads nothing but a polled register
+static bool IsPollingOp(const BlockCache::Op &op)
+{
+	switch(op.opcode)
+	{
+		case 0x00: return true; // NOP
+		case 0xE6: case 0xEE: case 0xF6: case 0xFE: return true; // AND/XOR/OR/CP n
+		case 0xF0: return IsPolledRegister(0xFF00 + op.operand); // LDH A,(n)
+		case 0xFA: return IsPolledRegister(op.operand); // LD A,(nn)
+		case 0xCB: return ((op.operand & 0xC7) == 0x47); // BIT b,A
+		// AND/XOR/OR/CP r (but not (HL), which could read anything)
+		default: return (op.opcode >= 0xA0 && op.opcode <= 0xBF && (op.opcode & 0x07) != 0x06);
+	}
+}
+
+// responsible for determining if a block is a busy wait (ie. polling LY for a line, STAT for a mode or IF for vblank)
+static bool IsIdleLoop(const BlockCache::Block &block)
+{
+	const BlockCache::Op &last = block.ops[block.count - 1];
+	u16 target;
+
+	switch(last.opcode)
+	{
+		case 0x18: case 0x20: case 0x28: case 0x30: case 0x38: target = (last.pc + 2 + (s8)last.operand); break; // JR
+		case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: target = last.operand; break; // JP
+		default: return false;
+	}
+
+	if (target != block.ops[0].pc) return false;
+
+	for (int i = 0; i < (block.count - 1); i++)
+	{
+		if (!IsPollingOp(block.ops[i])) return false;
+	}
+
+	return true;
+}
+
+// responsible for constructing the block cache
+BlockCache::BlockCache(GameBoy &gb) :
+	generation(0),
+	enabled(true),
+	idleLoops(true),
+	fuseOps(true),
+	gb(gb),
+	regions(REGION_ROMX + 512)
+{
+	memset(codePages, 0, sizeof(codePages));
+}
+
+// responsible for working out which cache region (if any) the code at pc lives in
+int BlockCache::GetRegion(u16 pc)
+{
+	if (pc <= Memory::Address::ROM_BK0_END) return REGION_ROM0;
+	if (pc <= Memory::Address::ROM_BK1_END)
+	{
+		// the legacy banking mode can map banks outside of the rom, so leave it to the interpreter
+		if (!gb.memory.useRomBank) return -1;
+
+		return REGION_ROMX + (gb.rom.romBank & gb.rom.romBankMask);
+	}
+	if (pc >= Memory::Address::WRAM_START && pc <= Memory::Address::WRAM_END) return REGION_WRAM;
+
+	// vram, external ram, echo ram and hram are always interpreted
+	return -1;
+}
+
+// responsible for returning the block starting at pc (NULL if pc can't be cached)
+const BlockCache::Block *BlockCache::Lookup(u16 pc)
+{
+	const int region = (enabled) ? GetRegion(pc) : -1;
+
+	if (region < 0) return NULL;
+
+	// drop everything rather than growing forever (ie. code that keeps rewriting itself)
+	if (blocks.size() >= BLOCK_MAX_COUNT) Flush();
+
+	std::vector<int> &index = regions[region];
+
+	if (index.empty()) index.assign((region == REGION_WRAM) ? 0x2000 : 0x4000, BLOCK_NONE);
+
+	int &slot = index[pc & ((region == REGION_WRAM) ? 0x1FFF : 0x3FFF)];
+
+	if (slot == BLOCK_NONE) slot = Decode(pc, region);
+
+	return (slot >= 0) ? &blocks[slot] : NULL;
+}
+
+// responsible for decoding a run of opcodes, up to the next jump or the end of the region
+int BlockCache::Decode(u16 pc, int region)
+{
+	int end = 0x8000;
+
+	if (region == REGION_ROM0) end = 0x4000;
+	else if (region == REGION_WRAM) end = ((pc | 0xFF) + 1);
+
+	Block block;
+	int address = pc;
+	block.count = 0;
+
+	while (block.count < BLOCK_MAX_OPS)
+	{
+		const u8 opcode = gb.memory.PeekByte(address);
+		const u8 length = opcodeLength[opcode];
+
+		// stop short of unused opcodes and opcodes that straddle a bank or page
+		if (length == 0 || (address + length) > end) break;
+
+		Op &op = block.ops[block.count++];
+		op.pc = address;
+		op.opcode = opcode;
+		op.operand = 0;
+		op.fused = 0;
+
+		if (length == 2) op.operand = gb.memory.PeekByte(address + 1);
+		else if (length == 3) op.operand = gb.memory.PeekWord(address + 1);
+
+		address += length;
+
+		if (EndsBlock(opcode)) break;
+	}
+
+	if (block.count == 0) return BLOCK_UNCACHEABLE;
+
+	block.idleLoop = IsIdleLoop(block);
+
+	// mark the opcodes that start a pair with the one after them
+	for (int i = 0; i < (block.count - 1); i++)
+	{
+		for (size_t j = 0; j < (sizeof(fusedPairs) / sizeof(fusedPairs[0])); j++)
+		{
+			if (block.ops[i].opcode == fusedPairs[j][0] && block.ops[i + 1].opcode == fusedPairs[j][1]) block.ops[i].fused = (j + 1);
+		}
+	}
+
+	if (region == REGION_WRAM) codePages[(pc - Memory::Address::WRAM_START) >> 8] = true;
+
+	blocks.push_back(block);
+
+	return (blocks.size() - 1);
+}
+
+// responsible for dropping the blocks decoded from a wram page that has just been written to
+void BlockCache::Invalidate(u16 address)
+{
+	const int page = ((address - Memory::Address::WRAM_START) >> 8);
+
+	if (!codePages[page]) return;
+
+	std::vector<int> &index = regions[REGION_WRAM];
+
+	for (int i = 0; i < 0x100; i++)
+	{
+		index[(page << 8) + i] = BLOCK_NONE;
+	}
+
+	codePages[page] = false;
+	generation += 1;
+}
+
+// responsible for telling the cpu to look its block up again (ie. after a rom bank switch)
+void BlockCache::Remap()
+{
+	generation += 1;
+}
+
+// responsible for dropping every cached block
+void BlockCache::Flush()
+{
+	for (size_t i = 0; i < regions.size(); i++)
+	{
+		regions[i].clear();
+	}
+
+	blocks.clear();
+	memset(codePages, 0, sizeof(codePages));
+	generation += 1;
+}
@@ -10,30 +10,26 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 
 // includes
+#include <algorithm>
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_sdl.h"
 #include "imgui/imgui_custom_extensions.h"
 #include "imgui/imgui_memory_editor.h"
 #include "tinyfiledialogs/tinyfiledialogs.h"
-#include "includes/bios.h"
 #include "includes/debugger.h"
-#include "includes/flags.h"
-#include "includes/input.h"
-#include "includes/interrupts.h"
-#include "includes/lcd.h"
+#include "includes/display.h"
+#include "includes/emulationThread.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/memory.h"
-#include "includes/rom.h"
 #include "stb/stb_image_write.h"
 #include "tinydir/tinydir.h"
-#include "includes/timer.h"
 #include "includes/ui.h"
 
 // init vars
 bool Debugger::stepThrough = false;
 bool Debugger::stopAtBreakpoint = false;
 bool Debugger::active = false;
-bool Debugger::stopMachine = false;
+bool Debugger::showStats = false;
 u16 Debugger::breakpoint = 0x00;
 const char *Debugger::modifyRegistersPopupTitle = "Modify Registers/Flags";
 const char *Debugger::memViewPopupTitle = "Memory View";
@@ -48,6 +44,7 @@ static char memValueBuffer[256];
 static char memSetBuffer[256];
 static char memSetAddressBuffer[256];
 static MemoryEditor memoryViewer;
+static GameBoy *gb = NULL;
 struct Reg
 {
 	enum name
@@ -56,19 +53,31 @@ struct Reg
 	};
 };
 static int modRegister = Reg::name::AF;
+// how many of the most run opcodes the stats window lists
+static const int statsTopOpcodes = 32;
+
+// responsible for writing a byte edited in the memory viewer back to the machine
+static void WriteEditedByte(u8 *data, size_t offset, u8 value)
+{
+	data[offset] = value;
+
+	EmulationThread::Lock();
+	gb->memory.mem[offset] = value;
+	gb->memory.InvalidateCaches((u16)offset);
+	EmulationThread::Unlock();
+}
+
+// responsible for attaching the debugger to a machine
+void Debugger::Init(GameBoy *gameBoy)
+{
+	gb = gameBoy;
+	memoryViewer.WriteFn = WriteEditedByte;
+}
 
 // responsible for resetting the system
 void Debugger::ResetSystem(bool reloadRom)
 {
-	stopMachine = false;
-	Memory::Init();
-	if (reloadRom) Rom::Reload();
-	if (Cpu::didLoadBios) Bios::Reload();
-	Cpu::Init();
-	Input::Init();
-	Timer::Init();
-	Lcd::Init();
-	Interrupts::Init();
+	gb->Reset(reloadRom);
 }
 
 // responsible for saving a screenshot
@@ -77,13 +86,16 @@ void Debugger::SaveScreenshot()
 	char outputFilename[512];
 	char outputFilePath[512];
 	const char *filename;
-	(filename = strrchr(Rom::filename, '/')) ? ++filename : (filename = Rom::filename);
+	(filename = strrchr(gb->rom.filename, '/')) ? ++filename : (filename = gb->rom.filename);
 
 	// get the current file extension and rename it to jpg
 	sscanf(filename,"%[^.]",outputFilename);
 	sprintf(outputFilename,"%s.jpg",outputFilename);
 	sprintf(outputFilePath,"screenshots/%s",outputFilename);
-	stbi_write_jpg(outputFilePath, 160, 144, 3, Lcd::screen, 100);
+
+	EmulationThread::Lock();
+	stbi_write_jpg(outputFilePath, 160, 144, 3, gb->lcd.GetScreen(), 100);
+	EmulationThread::Unlock();
 }
 
 // responsible for showing the debugger
@@ -91,8 +103,8 @@ void Debugger::ShowDebugger()
 {
 	active = true;
 	// make the GameBoy Lcd occupy the entire screen
-	Lcd::width = 160;
-	Lcd::height = 144;
+	Display::width = 160;
+	Display::height = 144;
 }
 
 // responsible for hiding the debugger
@@ -100,8 +112,8 @@ void Debugger::HideDebugger()
 {
 	active = false;
 	// make the GameBoy Lcd occupy the entire screen
-	Lcd::width = 640;
-	Lcd::height = 480;
+	Display::width = 640;
+	Display::height = 480;
 }
 
 // responsible for displaying the view memory popup
@@ -109,6 +121,7 @@ void Debugger::ViewMemoryPopup()
 {
 	if (ImGui::BeginPopupModal(memViewPopupTitle, NULL, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove))
 	{
+		const u8 *mem = EmulationThread::GetSnapshot().mem;
 		int i = 0xFFFF;
 
 		ImGui::SetWindowSize(memViewPopupTitle, ImVec2(208, 380));
@@ -119,7 +132,7 @@ void Debugger::ViewMemoryPopup()
 
 		while(i  > 0x0000)
 		{
-			ImGuiExtensions::TextWithColors("{FF0000}%04X: {FFFFFF}%02X\t{FF0000}%04X: {FFFFFF}%02X", i, Memory::ReadByte(i), i - 1, Memory::ReadByte(i - 1));
+			ImGuiExtensions::TextWithColors("{FF0000}%04X: {FFFFFF}%02X\t{FF0000}%04X: {FFFFFF}%02X", i, mem[i], i - 1, mem[i - 1]);
 			i -= 2;
 		}
 
@@ -140,7 +153,7 @@ void Debugger::GetMemoryValuePopup()
 		if (ImGui::InputText("a", memBuffer, 5, ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_CharsUppercase | ImGuiInputTextFlags_AutoSelectAll))
 		{
 			u16 address = (u16)strtol(memBuffer, NULL, 16);
-			sprintf(memValueBuffer, "%02X", Memory::ReadByte(address));
+			sprintf(memValueBuffer, "%02X", EmulationThread::GetSnapshot().mem[address]);
 		}
 
 		ImGui::Text("Value At Address:");
@@ -174,7 +187,9 @@ void Debugger::SetMemoryValuePopup()
 			u16 address = (u16)strtol(memSetAddressBuffer, NULL, 16);
 			u8 data = (u8)strtol(memSetBuffer, NULL, 16);
 
-			Memory::WriteByte(address, data);
+			EmulationThread::Lock();
+			gb->memory.WriteByte(address, data);
+			EmulationThread::Unlock();
 			ImGui::CloseCurrentPopup();
 		}
 
@@ -224,10 +239,24 @@ void Debugger::DumpMemory()
 	if (filename != NULL)
 	{
 		FILE *fp = fopen(filename, "wb");
-		fwrite(Memory::mem, sizeof(Memory::mem), 1, fp);
+		if (fp == NULL) return;
+
+		EmulationThread::Lock();
+		fwrite(gb->memory.mem, sizeof(gb->memory.mem), 1, fp);
+		EmulationThread::Unlock();
+		fclose(fp);
 	}
 }
 
+// responsible for dumping the stats counters to a csv file
+void Debugger::DumpStats()
+{
+	char const *validExtensions[2] = {"*.csv", "*.CSV"};
+	const char *filename = tinyfd_saveFileDialog("Save As", "stats.csv", 2, validExtensions, NULL);
+
+	if (filename != NULL) EmulationThread::GetSnapshot().stats.DumpCsv(filename);
+}
+
 // responsible for importing memory from a file
 void Debugger::ImportMemory()
 {
@@ -237,7 +266,15 @@ void Debugger::ImportMemory()
 	if (filename != NULL)
 	{
 		FILE *fp = fopen(filename, "rb");
-		fread(&Memory::mem, 1, 0x10000, fp);
+		if (fp == NULL) return;
+
+		EmulationThread::Lock();
+		fread(&gb->memory.mem, 1, 0x10000, fp);
+		gb->blockCache.Flush();
+		gb->lcd.FlushTiles();
+		gb->lcd.InvalidateOam();
+		EmulationThread::Unlock();
+		fclose(fp);
 	}
 }
 
@@ -246,26 +283,28 @@ void Debugger::RomInfoPopup()
 {
 	if (ImGui::BeginPopupModal(romInfoPopupTitle, NULL, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove))
 	{
+		const u8 *mem = EmulationThread::GetSnapshot().mem;
+
 		ImGui::SetWindowSize(romInfoPopupTitle, ImVec2(400, 380));
 		ImGuiExtensions::TextWithColors("{FF0000}Name:"); ImGui::SameLine();
 
 		// display the rom name
 		for (u16 i = Memory::Address::ROM_NAME_START; i < Memory::Address::ROM_NAME_END; i++)
 		{
-			if (Memory::ReadByte(i) != 0)
+			if (mem[i] != 0)
 			{
-				ImGui::Text("%c", Memory::ReadByte(i));
+				ImGui::Text("%c", mem[i]);
 				ImGui::SameLine();
 			}
 		}
 
 		ImGui::NewLine();
-		ImGuiExtensions::TextWithColors("{FF0000}Type: {FFFFFF}%02X", Memory::ReadByte(Memory::Address::ROM_TYPE));
-		ImGuiExtensions::TextWithColors("{FF0000}Rom-Size: {FFFFFF}%02X", Memory::ReadByte(Memory::Address::ROM_SIZE));
-		ImGuiExtensions::TextWithColors("{FF0000}Ram-Size: {FFFFFF}%02X", Memory::ReadByte(Memory::Address::ROM_RAM_SIZE));
+		ImGuiExtensions::TextWithColors("{FF0000}Type: {FFFFFF}%02X", mem[Memory::Address::ROM_TYPE]);
+		ImGuiExtensions::TextWithColors("{FF0000}Rom-Size: {FFFFFF}%02X", mem[Memory::Address::ROM_SIZE]);
+		ImGuiExtensions::TextWithColors("{FF0000}Ram-Size: {FFFFFF}%02X", mem[Memory::Address::ROM_RAM_SIZE]);
 		ImGuiExtensions::TextWithColors("{FF0000}File Path:");
 		ImGui::SameLine();
-		ImGui::TextWrapped("%s", Rom::filename);
+		ImGui::TextWrapped("%s", gb->rom.filename);
 		ImGui::NewLine();
 
 		if (ImGui::Button("Close", ImVec2(385, 0))) ImGui::CloseCurrentPopup();
@@ -292,16 +331,18 @@ void Debugger::SetBreakpointPopup()
 
 		if (ImGui::Button("Ok", ImVec2(80, 0)))
 		{
-			// convert the breakpoint buffer to a short
-			breakpoint = (u16)strtol(breakpointBuffer, NULL, 16);
-
 			if (strlen(breakpointBuffer) > 0)
 			{
-				stepThrough = false;
+				EmulationThread::Lock();
+				// convert the breakpoint buffer to a short
+				breakpoint = (u16)strtol(breakpointBuffer, NULL, 16);
 				stopAtBreakpoint = true;
 
 				// increase the program counter if needed, so we can run to the same breakpoint again
-				if (Cpu::pc.reg == breakpoint) Cpu::pc.reg += 1;
+				if (gb->cpu.pc.reg == breakpoint) gb->cpu.pc.reg += 1;
+				EmulationThread::Unlock();
+
+				EmulationThread::SendCommand(EmulationThread::Resume);
 				ImGui::CloseCurrentPopup();
 			}
 			else
@@ -344,6 +385,8 @@ void Debugger::ModifyRegistersPopup()
 
 	if (ImGui::BeginPopupModal(modifyRegistersPopupTitle, NULL, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove))
 	{
+		const EmulationThread::Snapshot &machine = EmulationThread::GetSnapshot();
+
 		ImGui::SetWindowSize(modifyRegistersPopupTitle, ImVec2(280, 310));
 		ImGui::Text("Choose The Register To Modify:");
 		ImGui::NewLine();
@@ -355,7 +398,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("AF", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::AF;
-			sprintf(regBuffer, "%04X", Cpu::af.reg);
+			sprintf(regBuffer, "%04X", machine.af);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -364,7 +407,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("BC", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::BC;
-			sprintf(regBuffer, "%04X", Cpu::bc.reg);
+			sprintf(regBuffer, "%04X", machine.bc);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -373,7 +416,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("DE", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::DE;
-			sprintf(regBuffer, "%04X", Cpu::de.reg);
+			sprintf(regBuffer, "%04X", machine.de);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -382,7 +425,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("HL", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::HL;
-			sprintf(regBuffer, "%04X", Cpu::hl.reg);
+			sprintf(regBuffer, "%04X", machine.hl);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -390,7 +433,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("SP", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::SP;
-			sprintf(regBuffer, "%04X", Cpu::sp.reg);
+			sprintf(regBuffer, "%04X", machine.sp);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -399,7 +442,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("PC", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::PC;
-			sprintf(regBuffer, "%04X", Cpu::pc.reg);
+			sprintf(regBuffer, "%04X", machine.pc);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -408,7 +451,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("LCDC", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::LCDC;
-			sprintf(regBuffer, "%02X", Memory::ReadByte(Memory::Address::LCDC));
+			sprintf(regBuffer, "%02X", machine.mem[Memory::Address::LCDC]);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -417,7 +460,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("STAT", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::STAT;
-			sprintf(regBuffer, "%02X", Memory::ReadByte(Memory::Address::STAT));
+			sprintf(regBuffer, "%02X", machine.mem[Memory::Address::STAT]);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -425,7 +468,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("LY", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::LY;
-			sprintf(regBuffer, "%02X", Memory::ReadByte(Memory::Address::LY));
+			sprintf(regBuffer, "%02X", machine.mem[Memory::Address::LY]);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -434,7 +477,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("IME", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::IME;
-			sprintf(regBuffer, "%d", Interrupts::ime);
+			sprintf(regBuffer, "%d", machine.ime);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -443,7 +486,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("IF", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::IF;
-			sprintf(regBuffer, "%02X", Memory::ReadByte(Memory::Address::IF));
+			sprintf(regBuffer, "%02X", machine.mem[Memory::Address::IF]);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -452,7 +495,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("IE", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::IE;
-			sprintf(regBuffer, "%02X", Memory::ReadByte(Memory::Address::IE));
+			sprintf(regBuffer, "%02X", machine.mem[Memory::Address::IE]);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -460,7 +503,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("TIMA", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::TIMA;
-			sprintf(regBuffer, "%02X", Memory::ReadByte(Memory::Address::TIMA));
+			sprintf(regBuffer, "%02X", machine.mem[Memory::Address::TIMA]);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -469,7 +512,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("TAC", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::TAC;
-			sprintf(regBuffer, "%02X", Memory::ReadByte(Memory::Address::TAC));
+			sprintf(regBuffer, "%02X", machine.mem[Memory::Address::TAC]);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -478,7 +521,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("TMA", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::TMA;
-			sprintf(regBuffer, "%02X", Memory::ReadByte(Memory::Address::TMA));
+			sprintf(regBuffer, "%02X", machine.mem[Memory::Address::TMA]);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -487,7 +530,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("DIV", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::DIV;
-			sprintf(regBuffer, "%02X", Memory::ReadByte(Memory::Address::DIV));
+			sprintf(regBuffer, "%02X", machine.mem[Memory::Address::DIV]);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -499,7 +542,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("Z", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::Z;
-			sprintf(regBuffer, "%d", Flags::Get(Flags::z));
+			sprintf(regBuffer, "%d", (machine.af & Flags::z) ? 1 : 0);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -508,7 +551,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("N", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::N;
-			sprintf(regBuffer, "%d", Flags::Get(Flags::n));
+			sprintf(regBuffer, "%d", (machine.af & Flags::n) ? 1 : 0);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -517,7 +560,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("H", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::H;
-			sprintf(regBuffer, "%d", Flags::Get(Flags::h));
+			sprintf(regBuffer, "%d", (machine.af & Flags::h) ? 1 : 0);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -526,7 +569,7 @@ void Debugger::ModifyRegistersPopup()
 		if (ImGui::Button("C", ImVec2(60, 0)))
 		{
 			modRegister = Reg::name::C;
-			sprintf(regBuffer, "%d", Flags::Get(Flags::c));
+			sprintf(regBuffer, "%d", (machine.af & Flags::c) ? 1 : 0);
 			ImGui::OpenPopup(setRegPopup);
 		}
 
@@ -558,29 +601,33 @@ void Debugger::ModifyRegistersPopup()
 
 				if (strlen(regBuffer) > 0)
 				{
+					EmulationThread::Lock();
+
 					switch(modRegister)
 					{
-						case Reg::name::AF: Cpu::af.reg = value; break;
-						case Reg::name::BC: Cpu::bc.reg = value; break;
-						case Reg::name::DE: Cpu::de.reg = value; break;
-						case Reg::name::HL: Cpu::hl.reg = value; break;
-						case Reg::name::SP: Cpu::sp.reg = value; break;
-						case Reg::name::PC: Cpu::pc.reg = value; break;
-						case Reg::name::LCDC: Memory::WriteByte(Memory::Address::LCDC, value & 0xFF);  break;
-						case Reg::name::STAT: Memory::WriteByte(Memory::Address::STAT, value & 0xFF); break;
-						case Reg::name::LY: Memory::mem[Memory::Address::LY] = (value & 0xFF); break;
-						case Reg::name::IME: Interrupts::ime = (value & 0x1); break;
-						case Reg::name::IF: Memory::WriteByte(Memory::Address::IF, value & 0xFF); break;
-						case Reg::name::IE: Memory::WriteByte(Memory::Address::IE, value & 0xFF); break;
-						case Reg::name::TIMA: Memory::WriteByte(Memory::Address::TIMA, value & 0xFF); break;
-						case Reg::name::TAC: Memory::WriteByte(Memory::Address::TAC, value & 0xFF); break;
-						case Reg::name::TMA: Memory::WriteByte(Memory::Address::TMA, value & 0xFF); break;
-						case Reg::name::DIV: Memory::WriteByte(Memory::Address::DIV, value & 0xFF); break;
-						case Reg::name::Z: if ((value & 0xF) == 1) Flags::Set(Flags::z); else Flags::Clear(Flags::z); break;
-						case Reg::name::N: if ((value & 0xF) == 1) Flags::Set(Flags::n); else Flags::Clear(Flags::n); break;
-						case Reg::name::H: if ((value & 0xF) == 1) Flags::Set(Flags::h); else Flags::Clear(Flags::h); break;
-						case Reg::name::C: if ((value & 0xF) == 1) Flags::Set(Flags::c); else Flags::Clear(Flags::c); break;
+						case Reg::name::AF: gb->cpu.flags.Discard(); gb->cpu.af.reg = value; break;
+						case Reg::name::BC: gb->cpu.bc.reg = value; break;
+						case Reg::name::DE: gb->cpu.de.reg = value; break;
+						case Reg::name::HL: gb->cpu.hl.reg = value; break;
+						case Reg::name::SP: gb->cpu.sp.reg = value; break;
+						case Reg::name::PC: gb->cpu.pc.reg = value; break;
+						case Reg::name::LCDC: gb->memory.WriteByte(Memory::Address::LCDC, value & 0xFF);  break;
+						case Reg::name::STAT: gb->memory.WriteByte(Memory::Address::STAT, value & 0xFF); break;
+						case Reg::name::LY: gb->memory.mem[Memory::Address::LY] = (value & 0xFF); break;
+						case Reg::name::IME: gb->interrupts.ime = (value & 0x1); break;
+						case Reg::name::IF: gb->memory.WriteByte(Memory::Address::IF, value & 0xFF); break;
+						case Reg::name::IE: gb->memory.WriteByte(Memory::Address::IE, value & 0xFF); break;
+						case Reg::name::TIMA: gb->memory.WriteByte(Memory::Address::TIMA, value & 0xFF); break;
+						case Reg::name::TAC: gb->memory.WriteByte(Memory::Address::TAC, value & 0xFF); break;
+						case Reg::name::TMA: gb->memory.WriteByte(Memory::Address::TMA, value & 0xFF); break;
+						case Reg::name::DIV: gb->memory.WriteByte(Memory::Address::DIV, value & 0xFF); break;
+						case Reg::name::Z: if ((value & 0xF) == 1) gb->cpu.flags.Set(Flags::z); else gb->cpu.flags.Clear(Flags::z); break;
+						case Reg::name::N: if ((value & 0xF) == 1) gb->cpu.flags.Set(Flags::n); else gb->cpu.flags.Clear(Flags::n); break;
+						case Reg::name::H: if ((value & 0xF) == 1) gb->cpu.flags.Set(Flags::h); else gb->cpu.flags.Clear(Flags::h); break;
+						case Reg::name::C: if ((value & 0xF) == 1) gb->cpu.flags.Set(Flags::c); else gb->cpu.flags.Clear(Flags::c); break;
 					}
+
+					EmulationThread::Unlock();
 					ImGui::CloseCurrentPopup();
 				}
 			}
@@ -602,46 +649,148 @@ void Debugger::ModifyRegistersPopup()
 // create a memory viewer window
 void Debugger::MemoryViewerWindow(const char *title, int width, int height, int x, int y)
 {
+	EmulationThread::Snapshot &machine = EmulationThread::GetSnapshot();
+
 	ImGui::Begin(title);
 	ImGui::SetWindowSize(title, ImVec2(width, height));
 	ImGui::SetWindowPos(title, ImVec2(x, y));
-	memoryViewer.DrawContents(Memory::mem, 0x10000, 0x0000);
-	memoryViewer.GotoAddrAndHighlight(Cpu::pc.reg, Cpu::pc.reg);
+	// edits land in the snapshot straight away, and in the machine through WriteEditedByte
+	memoryViewer.DrawContents(machine.mem, 0x10000, 0x0000);
+	memoryViewer.GotoAddrAndHighlight(machine.pc, machine.pc);
 	ImGui::End();
 }
 
 // responsible for displaying the register viewer window
 void Debugger::RegisterViewerWindow(const char *title, int width, int height, int x, int y)
 {
-	bool flagZ = Flags::Get(Flags::z);
-	bool flagN = Flags::Get(Flags::n);
-	bool flagH = Flags::Get(Flags::h);
-	bool flagC = Flags::Get(Flags::c);
+	const EmulationThread::Snapshot &machine = EmulationThread::GetSnapshot();
+	bool flagZ = (machine.af & Flags::z);
+	bool flagN = (machine.af & Flags::n);
+	bool flagH = (machine.af & Flags::h);
+	bool flagC = (machine.af & Flags::c);
 
 	ImGui::Begin(title, NULL, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
 	ImGui::SetWindowSize(title, ImVec2(width, height));
 	ImGui::SetWindowPos(title, ImVec2(x, y));
-	ImGuiExtensions::TextWithColors("{FF0000}AF: {FFFFFF}%04X", Cpu::af.reg); ImGui::SameLine(); ImGui::Indent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}LCDC: {FFFFFF}%02X", Memory::ReadByte(Memory::Address::LCDC)); ImGui::SameLine(); ImGui::NewLine(); ImGui::Unindent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}BC: {FFFFFF}%04X", Cpu::bc.reg); ImGui::SameLine(); ImGui::Indent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}STAT: {FFFFFF}%02X", Memory::ReadByte(Memory::Address::STAT)); ImGui::Unindent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}DE: {FFFFFF}%04X", Cpu::de.reg); ImGui::SameLine(); ImGui::Indent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}LY:   {FFFFFF}%02X", Memory::ReadByte(Memory::Address::LY)); ImGui::Unindent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}HL: {FFFFFF}%04X", Cpu::hl.reg); ImGui::SameLine(); ImGui::Indent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}AF: {FFFFFF}%04X", machine.af); ImGui::SameLine(); ImGui::Indent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}LCDC: {FFFFFF}%02X", machine.mem[Memory::Address::LCDC]); ImGui::SameLine(); ImGui::NewLine(); ImGui::Unindent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}BC: {FFFFFF}%04X", machine.bc); ImGui::SameLine(); ImGui::Indent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}STAT: {FFFFFF}%02X", machine.mem[Memory::Address::STAT]); ImGui::Unindent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}DE: {FFFFFF}%04X", machine.de); ImGui::SameLine(); ImGui::Indent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}LY:   {FFFFFF}%02X", machine.mem[Memory::Address::LY]); ImGui::Unindent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}HL: {FFFFFF}%04X", machine.hl); ImGui::SameLine(); ImGui::Indent(80.f);
 	ImGuiExtensions::TextWithColors("{FF0000}IME:  {FFFFFF}%d", 0); ImGui::Unindent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}SP: {FFFFFF}%04X", Cpu::sp.reg); ImGui::SameLine(); ImGui::Indent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}IE:   {FFFFFF}%02X", Memory::ReadByte(Memory::Address::IE)); ImGui::Unindent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}PC: {FFFFFF}%04X", Cpu::pc.reg); ImGui::SameLine(); ImGui::SameLine(); ImGui::Indent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}IF:   {FFFFFF}%02X", Memory::ReadByte(Memory::Address::IF)); ImGui::Unindent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}TIMA: {FFFFFF}%02X", Memory::ReadByte(Memory::Address::TIMA)); ImGui::SameLine(); ImGui::Indent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}DIV:  {FFFFFF}%02X", Memory::ReadByte(Memory::Address::DIV)); ImGui::Unindent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}TAC:  {FFFFFF}%02X", Memory::ReadByte(Memory::Address::TAC)); ImGui::SameLine(); ImGui::Indent(80.f);
-	ImGuiExtensions::TextWithColors("{FF0000}TMA:  {FFFFFF}%02X", Memory::ReadByte(Memory::Address::TMA)); ImGui::SameLine(); ImGui::Unindent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}SP: {FFFFFF}%04X", machine.sp); ImGui::SameLine(); ImGui::Indent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}IE:   {FFFFFF}%02X", machine.mem[Memory::Address::IE]); ImGui::Unindent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}PC: {FFFFFF}%04X", machine.pc); ImGui::SameLine(); ImGui::SameLine(); ImGui::Indent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}IF:   {FFFFFF}%02X", machine.mem[Memory::Address::IF]); ImGui::Unindent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}TIMA: {FFFFFF}%02X", machine.mem[Memory::Address::TIMA]); ImGui::SameLine(); ImGui::Indent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}DIV:  {FFFFFF}%02X", machine.mem[Memory::Address::DIV]); ImGui::Unindent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}TAC:  {FFFFFF}%02X", machine.mem[Memory::Address::TAC]); ImGui::SameLine(); ImGui::Indent(80.f);
+	ImGuiExtensions::TextWithColors("{FF0000}TMA:  {FFFFFF}%02X", machine.mem[Memory::Address::TMA]); ImGui::SameLine(); ImGui::Unindent(80.f);
 	ImGui::NewLine();
-	ImGuiExtensions::TextWithColors("{FF0000}Ins Ran: {FFFFFF}%d", Cpu::instructionsRan);
+	ImGuiExtensions::TextWithColors("{FF0000}Ins Ran: {FFFFFF}%d", machine.instructionsRan);
 	ImGui::Checkbox("Z", &flagZ); ImGui::SameLine();
 	ImGui::Checkbox("N", &flagN); ImGui::SameLine();
 	ImGui::Checkbox("H", &flagH); ImGui::SameLine();
 	ImGui::Checkbox("C", &flagC); ImGui::SameLine();
 	ImGui::End();
 }
+
+// responsible for displaying the stats window (opcode, memory, banking and interrupt counters)
+void Debugger::StatsWindow(const char *title)
+{
+	const Stats &stats = EmulationThread::GetSnapshot().stats;
+
+	ImGui::SetNextWindowSize(ImVec2(300, 400), ImGuiCond_FirstUseEver);
+	ImGui::Begin(title, &showStats);
+
+	if (!Stats::Available())
+	{
+		ImGui::TextWrapped("Built without COLLECT_STATS, so nothing is being counted.");
+		ImGui::End();
+		return;
+	}
+
+	if (ImGui::Button("Reset"))
+	{
+		EmulationThread::Lock();
+		gb->stats.Reset();
+		EmulationThread::Unlock();
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Dump CSV")) DumpStats();
+
+	if (ImGui::CollapsingHeader("Interrupts"))
+	{
+		for (int i = 0; i < STATS_INTERRUPT_COUNT; i++)
+		{
+			ImGui::Text("%-8s %lld", Stats::InterruptName(i), stats.interrupts[i]);
+		}
+	}
+
+	if (ImGui::CollapsingHeader("Memory"))
+	{
+		ImGui::Columns(3, "memoryStats");
+		ImGui::Text("Region"); ImGui::NextColumn();
+		ImGui::Text("Reads"); ImGui::NextColumn();
+		ImGui::Text("Writes"); ImGui::NextColumn();
+
+		for (int i = 0; i < Stats::REGION_COUNT; i++)
+		{
+			ImGui::Text("%s", Stats::RegionName(i)); ImGui::NextColumn();
+			ImGui::Text("%lld", stats.reads[i]); ImGui::NextColumn();
+			ImGui::Text("%lld", stats.writes[i]); ImGui::NextColumn();
+		}
+
+		ImGui::Columns(1);
+	}
+
+	if (ImGui::CollapsingHeader("Banking"))
+	{
+		ImGui::Text("Rom bank switches: %lld", stats.romBankSwitches);
+		ImGui::Text("Ram bank switches: %lld", stats.ramBankSwitches);
+	}
+
+	if (ImGui::CollapsingHeader("Opcodes"))
+	{
+		// 0x000-0x0FF are the base opcodes, 0x100-0x1FF the cb prefixed ones
+		int order[0x200];
+
+		for (int i = 0; i < 0x200; i++) order[i] = i;
+
+		std::partial_sort(order, (order + statsTopOpcodes), (order + 0x200), [&stats](int a, int b)
+		{
+			const long long countA = (a < 0x100) ? stats.opcodeCount[a] : stats.extendedCount[a - 0x100];
+			const long long countB = (b < 0x100) ? stats.opcodeCount[b] : stats.extendedCount[b - 0x100];
+
+			return countA > countB;
+		});
+
+		ImGui::Text("Cycles halted: %lld", stats.haltedCycles);
+		ImGui::Text("Cycles skipped in idle loops: %lld", stats.idleLoopCycles);
+		ImGui::Columns(3, "opcodeStats");
+		ImGui::Text("Opcode"); ImGui::NextColumn();
+		ImGui::Text("Count"); ImGui::NextColumn();
+		ImGui::Text("Cycles"); ImGui::NextColumn();
+
+		for (int i = 0; i < statsTopOpcodes; i++)
+		{
+			const bool extended = (order[i] >= 0x100);
+			const u8 opcode = (order[i] & 0xFF);
+			const long long count = (extended) ? stats.extendedCount[opcode] : stats.opcodeCount[opcode];
+			const long long cycles = (extended) ? stats.extendedCycles[opcode] : stats.opcodeCycles[opcode];
+
+			if (count == 0) break;
+
+			ImGui::Text((extended) ? "CB %02X" : "%02X", opcode); ImGui::NextColumn();
+			ImGui::Text("%lld", count); ImGui::NextColumn();
+			ImGui::Text("%lld", cycles); ImGui::NextColumn();
+		}
+
+		ImGui::Columns(1);
+	}
+
+	ImGui::End();
+}
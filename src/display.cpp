@@ -0,0 +1,47 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include <SDL2/SDL_opengl.h>
+#include "includes/display.h"
+
+// init vars
+int Display::height = 480;
+int Display::width = 640;
+static GLuint texture;
+
+// responsible for initializing the display
+void Display::Init()
+{
+	// setup opengl for the game window
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glEnable(GL_TEXTURE_2D);
+}
+
+// responsible for updating the screen texture
+void Display::UpdateTexture(const u8 *screen)
+{
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 160, 144, 0, GL_RGB, GL_UNSIGNED_BYTE, screen);
+}
+
+// responsible for rendering the image to the screen
+void Display::Render()
+{
+	glBegin(GL_QUADS);
+	glTexCoord2f(0, 0); glVertex2f(0, 0);
+	glTexCoord2f(0, 1); glVertex2f(0, height);
+	glTexCoord2f(1, 1); glVertex2f(width, height);
+	glTexCoord2f(1, 0); glVertex2f(width, 0);
+	glEnd();
+}
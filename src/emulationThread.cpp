@@ -0,0 +1,295 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "includes/debugger.h"
+#include "includes/emulationThread.h"
+#include "includes/gameboy.h"
+#include "includes/log.h"
+#include "includes/spscQueue.h"
+#include "includes/tripleBuffer.h"
+#include "includes/ui.h"
+
+// definitions
+#define COMMAND_QUEUE_SIZE 64
+// how long the thread sleeps while the machine is paused or stopped
+#define IDLE_SLEEP_MS 1
+// how far emulation may fall behind real time before the pacing gives up catching up
+#define MAX_FRAME_LAG_MS 100
+
+// init vars
+static GameBoy *gb = NULL;
+static std::thread *thread = NULL;
+static std::mutex machineMutex;
+static std::atomic<bool> quit(false);
+static std::atomic<bool> uiWaiting(false);
+static std::atomic<int> framesRan(0);
+// the snapshots rotate like a triple buffer: filled by the emulation thread, ready for the ui, shown by the ui
+static std::mutex snapshotMutex;
+static std::atomic<bool> snapshotReady(false);
+static EmulationThread::Snapshot *snapshotBack = NULL;
+static EmulationThread::Snapshot *snapshotReadyBuffer = NULL;
+static EmulationThread::Snapshot *snapshotFront = NULL;
+static SpscQueue<u8, COMMAND_QUEUE_SIZE> commands;
+static TripleBuffer frames;
+// the real time length of a single GameBoy frame
+static const std::chrono::nanoseconds framePeriod((LCD_FRAME_CYCLES * 1000000000LL) / MAX_CYCLES);
+
+// responsible for starting the emulation thread
+void EmulationThread::Start(GameBoy *gameBoy)
+{
+	gb = gameBoy;
+	quit = false;
+	snapshotBack = new Snapshot(*gb);
+	snapshotReadyBuffer = new Snapshot(*gb);
+	snapshotFront = new Snapshot(*gb);
+	snapshotReady = false;
+	FillSnapshot(*snapshotFront);
+	thread = new std::thread(&EmulationThread::Run);
+}
+
+// responsible for stopping the emulation thread and waiting for it to finish
+void EmulationThread::Shutdown()
+{
+	if (thread == NULL) return;
+
+	quit = true;
+	thread->join();
+	delete thread;
+	thread = NULL;
+
+	delete snapshotBack;
+	delete snapshotReadyBuffer;
+	delete snapshotFront;
+	snapshotBack = snapshotReadyBuffer = snapshotFront = NULL;
+}
+
+// responsible for taking ownership of the machine from the render thread, for an action that changes it (blocks until the current frame finishes)
+void EmulationThread::Lock()
+{
+	uiWaiting = true;
+	machineMutex.lock();
+	uiWaiting = false;
+}
+
+// responsible for handing the machine back to the emulation thread
+void EmulationThread::Unlock()
+{
+	machineMutex.unlock();
+}
+
+// responsible for sending a debugger command to the emulation thread
+void EmulationThread::SendCommand(u8 command)
+{
+	commands.Push(command);
+}
+
+// responsible for returning the newest finished frame (returns NULL if there isn't a new one)
+const u8 *EmulationThread::AcquireFrame()
+{
+	return frames.Acquire();
+}
+
+// responsible for showing the newest snapshot of the machine, if there is one (called once per ui frame)
+void EmulationThread::AcquireSnapshot()
+{
+	if (!snapshotReady) return;
+
+	std::lock_guard<std::mutex> lock(snapshotMutex);
+	std::swap(snapshotReadyBuffer, snapshotFront);
+	snapshotReady = false;
+}
+
+// responsible for returning the snapshot of the machine the ui is showing
+EmulationThread::Snapshot &EmulationThread::GetSnapshot()
+{
+	return *snapshotFront;
+}
+
+// responsible for returning how many frames were emulated since the last call
+int EmulationThread::TakeFrameCount()
+{
+	return framesRan.exchange(0);
+}
+
+// responsible for applying the queued debugger commands
+void EmulationThread::ProcessCommands()
+{
+	u8 command;
+
+	while (commands.Pop(command))
+	{
+		// a movie only lines up with whole frames run in order
+		const bool inMovie = (gb->movie.IsRecording() || gb->movie.IsPlaying());
+
+		switch(command)
+		{
+			case Resume: Debugger::stepThrough = false; break;
+			case Pause: Debugger::stepThrough = true; break;
+			case TogglePause: Debugger::stepThrough = !Debugger::stepThrough; break;
+			case ResumeNoBreak: Debugger::stepThrough = false; Debugger::stopAtBreakpoint = false; break;
+			case PauseNoBreak: Debugger::stepThrough = true; Debugger::stopAtBreakpoint = false; break;
+			case Reset: Debugger::ResetSystem(); break;
+			case Restart: Debugger::ResetSystem(true); break;
+
+			case StepForward:
+				if (!Debugger::stepThrough || inMovie) break;
+
+				// make sure there's a snapshot to step back to
+				if (!gb->rewind.HasSnapshot()) gb->rewind.Capture();
+
+				// step a single opcode, rather than a fused pair
+				gb->blockCache.fuseOps = false;
+				gb->cpu.Step();
+			break;
+
+			// rewinds a single instruction while stepping, or to the previous snapshot while running
+			case StepBackward:
+				if (inMovie) break;
+
+				if (!Debugger::stepThrough)
+				{
+					gb->rewind.StepBack();
+					break;
+				}
+
+				if (gb->rewind.StepBackInstruction()) break;
+
+				// with nothing left to go back to, only the very first instruction resets the machine
+				if (gb->cpu.totalCycles == 0) Debugger::ResetSystem();
+				else Log::Print("No rewind history to step back through");
+			break;
+		}
+	}
+}
+
+// responsible for emulating a single frame (returns false if the machine stopped or hit a breakpoint)
+bool EmulationThread::EmulateFrame()
+{
+	// a movie only lines up with whole frames, so a breakpoint waits until the movie has stopped
+	const bool breakpoint = (Debugger::stopAtBreakpoint && !gb->movie.IsRecording() && !gb->movie.IsPlaying());
+
+	gb->cpu.cycles = 0;
+	gb->movie.BeginFrame();
+
+	// a breakpoint can sit on the second opcode of a fused pair
+	gb->blockCache.fuseOps = !breakpoint;
+
+	while (gb->cpu.cycles < LCD_FRAME_CYCLES)
+	{
+		if (gb->cpu.stopMachine) return false;
+		if (breakpoint && (gb->cpu.pc.reg == Debugger::breakpoint))
+		{
+			Debugger::stepThrough = true;
+			return false;
+		}
+
+		gb->cpu.Step();
+	}
+
+	return true;
+}
+
+// responsible for copying the finished frame into the triple buffer for the render thread
+void EmulationThread::PublishFrame()
+{
+	if (!gb->lcd.frameReady) return;
+
+	memcpy(frames.GetBackBuffer(), gb->lcd.GetScreen(), TRIPLE_BUFFER_SIZE);
+	frames.Publish();
+	gb->lcd.frameReady = false;
+}
+
+// responsible for copying what the ui shows out of the machine
+void EmulationThread::FillSnapshot(Snapshot &snapshot)
+{
+	// let the ui see the real F register
+	gb->cpu.flags.Resolve();
+
+	snapshot.af = gb->cpu.af.reg;
+	snapshot.bc = gb->cpu.bc.reg;
+	snapshot.de = gb->cpu.de.reg;
+	snapshot.hl = gb->cpu.hl.reg;
+	snapshot.sp = gb->cpu.sp.reg;
+	snapshot.pc = gb->cpu.pc.reg;
+	snapshot.instructionsRan = gb->cpu.instructionsRan;
+	snapshot.ime = gb->interrupts.ime;
+	snapshot.romLoaded = gb->rom.HasLoaded();
+	snapshot.recording = gb->movie.IsRecording();
+	snapshot.playing = gb->movie.IsPlaying();
+	gb->memory.CopyMap(snapshot.mem);
+	snapshot.stats.CopyCounters(gb->stats);
+}
+
+// responsible for handing the ui a new snapshot of the machine, once it has picked up the last one
+void EmulationThread::PublishSnapshot()
+{
+	if (snapshotReady) return;
+
+	FillSnapshot(*snapshotBack);
+
+	std::lock_guard<std::mutex> lock(snapshotMutex);
+	std::swap(snapshotBack, snapshotReadyBuffer);
+	snapshotReady = true;
+}
+
+// responsible for the emulation loop
+void EmulationThread::Run()
+{
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now();
+
+	while (!quit)
+	{
+		machineMutex.lock();
+
+		gb->input.ProcessQueuedKeys();
+		ProcessCommands();
+
+		const bool running = (!Debugger::stepThrough && !gb->cpu.stopMachine);
+		const bool turbo = Ui::turbo;
+		const int speed = Ui::speed;
+
+		if (running && EmulateFrame())
+		{
+			gb->movie.EndFrame();
+			gb->rewind.OnFrame();
+			framesRan += 1;
+		}
+
+		PublishFrame();
+		PublishSnapshot();
+		machineMutex.unlock();
+
+		// let a waiting ui action in between frames
+		while (uiWaiting) std::this_thread::yield();
+
+		if (!running)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MS));
+			deadline = std::chrono::steady_clock::now();
+			continue;
+		}
+
+		if (turbo) continue;
+
+		// pace the machine to real time, running speed frames per GameBoy frame period
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+		deadline += (framePeriod / speed);
+
+		if ((now - deadline) > std::chrono::milliseconds(MAX_FRAME_LAG_MS)) deadline = now;
+		else std::this_thread::sleep_until(deadline);
+	}
+}
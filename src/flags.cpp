@@ -8,12 +8,8 @@
  */
 
 // includes
-#include "includes/cpu.h"
 #include "includes/flags.h"
 
-// definitions
-#define F Cpu::af.lo
-
 // init vars
 const u8 Flags::z = 0x80;
 const u8 Flags::n = 0x40;
@@ -21,20 +17,166 @@ const u8 Flags::h = 0x20;
 const u8 Flags::c = 0x10;
 const u8 Flags::all = (Flags::z  | Flags::n | Flags::h | Flags::c);
 
+// the lookup tables below are filled in by the compiler, calling an entry function once per index
+#define TABLE_4(entry, i) entry(i), entry((i) + 1), entry((i) + 2), entry((i) + 3)
+#define TABLE_16(entry, i) TABLE_4(entry, i), TABLE_4(entry, (i) + 0x4), TABLE_4(entry, (i) + 0x8), TABLE_4(entry, (i) + 0xC)
+#define TABLE_64(entry, i) TABLE_16(entry, i), TABLE_16(entry, (i) + 0x10), TABLE_16(entry, (i) + 0x20), TABLE_16(entry, (i) + 0x30)
+#define TABLE_256(entry, i) TABLE_64(entry, i), TABLE_64(entry, (i) + 0x40), TABLE_64(entry, (i) + 0x80), TABLE_64(entry, (i) + 0xC0)
+#define TABLE_1024(entry, i) TABLE_256(entry, i), TABLE_256(entry, (i) + 0x100), TABLE_256(entry, (i) + 0x200), TABLE_256(entry, (i) + 0x300)
+#define TABLE_2048(entry) TABLE_1024(entry, 0), TABLE_1024(entry, 0x400)
+
+// responsible for the add/adc/sub/sbc flags of: subtract << 10 | half carry (bit 4 of lhs ^ rhs ^ result) << 9 | the 9 bit result
+static constexpr u8 AluFlags(int i)
+{
+	return ((((i & 0xFF) == 0) ? Flags::z : 0) | ((i & 0x400) ? Flags::n : 0) | ((i & 0x200) ? Flags::h : 0) | ((i & 0x100) ? Flags::c : 0));
+}
+
+// responsible for the inc flags of a result
+static constexpr u8 IncFlags(int result)
+{
+	return (((result == 0) ? Flags::z : 0) | (((result & 0xF) == 0) ? Flags::h : 0));
+}
+
+// responsible for the dec flags of a result
+static constexpr u8 DecFlags(int result)
+{
+	return (((result == 0) ? Flags::z : 0) | Flags::n | (((result & 0xF) == 0xF) ? Flags::h : 0));
+}
+
+// responsible for the daa adjustments, in the order the cpu applies them (an a above 0xFF sets the carry)
+static constexpr unsigned int DaaAddLow(unsigned int a, int h)
+{
+	return (h || ((a & 0xF) > 0x09)) ? (a + 0x06) : a;
+}
+
+static constexpr unsigned int DaaAddHigh(unsigned int a, int c)
+{
+	return (c || (a > 0x9F)) ? (a + 0x60) : a;
+}
+
+static constexpr unsigned int DaaSubLow(unsigned int a, int h)
+{
+	return (h) ? ((a - 0x06) & 0xFF) : a;
+}
+
+static constexpr unsigned int DaaSubHigh(unsigned int a, int c)
+{
+	return (c) ? (a - 0x60) : a;
+}
+
+static constexpr u16 DaaPack(unsigned int a, int n, int c)
+{
+	return ((a & 0xFF) | ((((a & 0xFF) == 0) ? Flags::z : 0) << 8) | (((n) ? Flags::n : 0) << 8) | (((c || (a & 0x100)) ? Flags::c : 0) << 8));
+}
+
+// responsible for the daa result of: n << 10 | h << 9 | c << 8 | a, with the new flags in the high byte and the adjusted a in the low byte
+static constexpr u16 DaaResult(int i)
+{
+	return DaaPack((i & 0x400) ? DaaSubHigh(DaaSubLow(i & 0xFF, i & 0x200), i & 0x100) : DaaAddHigh(DaaAddLow(i & 0xFF, i & 0x200), i & 0x100), i & 0x400, i & 0x100);
+}
+
+static constexpr u8 aluFlags[0x800] = {TABLE_2048(AluFlags)};
+static constexpr u8 incFlags[0x100] = {TABLE_256(IncFlags, 0)};
+static constexpr u8 decFlags[0x100] = {TABLE_256(DecFlags, 0)};
+static constexpr u16 daaResults[0x800] = {TABLE_2048(DaaResult)};
+
+// responsible for binding the flags to the F register
+Flags::Flags(u8 &f) : f(f), operation(NONE), lhs(0), rhs(0), carry(0)
+{
+
+}
+
 // responsible for getting a flags value
 u8 Flags::Get(u8 flag)
 {
-	return (F & flag) ? 1 : 0;
+	if (operation != NONE) Resolve();
+
+	return (f & flag) ? 1 : 0;
 }
 
 // responsible for setting a flag
 void Flags::Set(u8 flags)
 {
-	F |= flags;
+	if (operation != NONE) Resolve();
+
+	f |= flags;
 }
 
 // responsible for clearing a flag
 void Flags::Clear(u8 flags)
 {
-	F &= ~flags;
+	if (operation != NONE) Resolve();
+
+	f &= ~flags;
+}
+
+// responsible for recording an alu operation, so its flags can be worked out when they are next read
+void Flags::Defer(u8 operation, u8 lhs, u8 rhs, u8 carry)
+{
+	// inc/dec keep the carry flag, so the previous operation has to land first
+	if ((operation == INC || operation == DEC) && this->operation != NONE) Resolve();
+
+	this->operation = operation;
+	this->lhs = lhs;
+	this->rhs = rhs;
+	this->carry = carry;
+}
+
+// responsible for working out the flags of the last recorded alu operation
+void Flags::Resolve()
+{
+	int result = 0;
+
+	switch(operation)
+	{
+		case ADD:
+		case ADC:
+			result = (lhs + carry + rhs);
+			f = ((f & 0x0F) | aluFlags[result | (((lhs ^ rhs ^ result) & 0x10) << 5)]);
+		break;
+
+		case SUB:
+		case SBC:
+			result = ((lhs - carry - rhs) & 0x1FF);
+			f = ((f & 0x0F) | aluFlags[0x400 | result | (((lhs ^ rhs ^ result) & 0x10) << 5)]);
+		break;
+
+		case INC:
+			f = ((f & (0x0F | c)) | incFlags[(u8)(lhs + 1)]);
+		break;
+
+		case DEC:
+			f = ((f & (0x0F | c)) | decFlags[(u8)(lhs - 1)]);
+		break;
+
+		case AND:
+			f = ((f & 0x0F) | h | aluFlags[lhs & rhs]);
+		break;
+
+		case OR:
+			// or/xor record their result as lhs
+			f = ((f & 0x0F) | aluFlags[lhs]);
+		break;
+
+		default: return;
+	}
+
+	operation = NONE;
+}
+
+// responsible for decimal adjusting a after a bcd add/sub
+void Flags::Daa(u8 &a)
+{
+	if (operation != NONE) Resolve();
+
+	const u16 adjusted = daaResults[((f & (n | h | c)) << 4) | a];
+
+	a = (adjusted & 0xFF);
+	f = ((f & 0x0F) | (adjusted >> 8));
+}
+
+// responsible for dropping the recorded alu operation (ie. when F itself is overwritten)
+void Flags::Discard()
+{
+	operation = NONE;
 }
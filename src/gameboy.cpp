@@ -0,0 +1,174 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include "includes/gameboy.h"
+
+// responsible for constructing a powered on machine (with no rom inserted)
+GameBoy::GameBoy() :
+	cpu(*this),
+	memory(*this),
+	rom(*this),
+	mbc(*this),
+	lcd(*this),
+	timer(*this),
+	interrupts(*this),
+	input(*this),
+	bios(*this),
+	blockCache(*this),
+	scheduler(*this),
+	rewind(*this),
+	movie(*this),
+	stats(*this)
+{
+	memory.Init();
+	Init();
+}
+
+// responsible for loading a rom (and optionally a bios) and starting the machine
+bool GameBoy::LoadRom(const char *romPath, const char *biosPath)
+{
+	memory.Init();
+
+	if (!rom.Load(romPath)) return false;
+
+	cpu.didLoadBios = (biosPath != NULL) ? bios.Load(biosPath) : false;
+	Init();
+
+	return true;
+}
+
+// responsible for initializing the machine
+void GameBoy::Init()
+{
+	interrupts.Init();
+	cpu.Init();
+	timer.Init();
+	lcd.Init();
+	scheduler.Init();
+	input.Init();
+	blockCache.Flush();
+	rewind.Clear();
+	movie.Stop();
+	stats.Reset();
+}
+
+// responsible for resetting the machine
+void GameBoy::Reset(bool reloadRom)
+{
+	cpu.stopMachine = false;
+	memory.Init();
+	if (reloadRom) rom.Reload();
+	if (cpu.didLoadBios) bios.Reload();
+	Init();
+}
+
+// responsible for running the machine for a single frame
+bool GameBoy::RunFrame()
+{
+	cpu.cycles = 0;
+	movie.BeginFrame();
+
+	while (cpu.cycles < LCD_FRAME_CYCLES)
+	{
+		if (cpu.stopMachine) break;
+
+		cpu.Step();
+	}
+
+	// let anything outside of the cpu see the real F register
+	cpu.flags.Resolve();
+
+	if (cpu.stopMachine) return false;
+
+	movie.EndFrame();
+	rewind.OnFrame();
+
+	return true;
+}
+
+// responsible for returning the rom's global checksum (from its header)
+u16 GameBoy::RomChecksum()
+{
+	if (rom.rom == NULL) return 0;
+
+	return ((rom.rom[0x14E] << 8) | rom.rom[0x14F]);
+}
+
+// responsible for saving/loading every component's state
+void GameBoy::Serialize(StateBuffer &state)
+{
+	cpu.Serialize(state);
+	memory.Serialize(state);
+	rom.Serialize(state);
+	lcd.Serialize(state);
+	timer.Serialize(state);
+	interrupts.Serialize(state);
+	input.Serialize(state);
+}
+
+// responsible for returning how many bytes a save state of the loaded rom takes
+size_t GameBoy::StateSize()
+{
+	StateBuffer measure((u8 *)NULL, 0);
+	Serialize(measure);
+
+	return (sizeof(StateHeader) + measure.Offset());
+}
+
+// responsible for saving the whole machine into a buffer (returns the size of the state, or 0 if the buffer is too small)
+size_t GameBoy::SaveState(u8 *buffer, size_t size)
+{
+	const size_t stateSize = StateSize();
+
+	if (buffer == NULL || size < stateSize) return 0;
+
+	// get the machine into a state where nothing is deferred
+	cpu.flags.Resolve();
+	scheduler.Sync();
+
+	StateHeader header;
+	memcpy(header.magic, STATE_MAGIC, sizeof(header.magic));
+	header.version = STATE_VERSION;
+	header.romChecksum = RomChecksum();
+	header.size = (unsigned int)stateSize;
+	memcpy(buffer, &header, sizeof(StateHeader));
+
+	StateBuffer state(&buffer[sizeof(StateHeader)], (size - sizeof(StateHeader)));
+	Serialize(state);
+
+	return stateSize;
+}
+
+// responsible for loading the whole machine from a buffer (returns false if the state doesn't belong to this rom/version)
+bool GameBoy::LoadState(const u8 *buffer, size_t size)
+{
+	StateHeader header;
+
+	if (buffer == NULL || size < sizeof(StateHeader)) return false;
+
+	memcpy(&header, buffer, sizeof(StateHeader));
+
+	if (memcmp(header.magic, STATE_MAGIC, sizeof(header.magic)) != 0) return false;
+	if (header.version != STATE_VERSION || header.romChecksum != RomChecksum()) return false;
+	if (header.size != size || header.size != StateSize()) return false;
+
+	// drop the cycles the old state hadn't caught up on yet
+	scheduler.Sync();
+
+	StateBuffer state(&buffer[sizeof(StateHeader)], (size - sizeof(StateHeader)));
+	Serialize(state);
+
+	// the page table and caches were built from the old memory
+	memory.MapPages();
+	scheduler.Sync();
+	blockCache.Flush();
+
+	return !state.Failed();
+}
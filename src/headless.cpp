@@ -0,0 +1,326 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+
+// includes
+#include <chrono>
+#include <getopt.h>
+#include <unistd.h>
+#include "includes/gameboy.h"
+#include "includes/log.h"
+#include "includes/profiler.h"
+#include "includes/typedefs.h"
+#include "includes/workerPool.h"
+#include "stb/stb_image_write.h"
+
+// vars
+static const char *romPath = NULL;
+static const char *biosPath = NULL;
+static const char *screenPath = NULL;
+static const char *serialPath = NULL;
+static const char *jobListPath = NULL;
+static const char *playMoviePath = NULL;
+static const char *recordMoviePath = NULL;
+static const char *statsPath = NULL;
+static int frameCount = 600;
+static int framesRan = 0;
+static int threadCount = 0;
+static bool useBlockCache = true;
+static bool useIdleLoops = true;
+static bool useFusedOps = true;
+static int frameSkip = 0;
+static bool renderEnabled = true;
+static bool benchMode = false;
+static int benchRomCount = 0;
+static char **benchRoms = NULL;
+
+// responsible for printing the command line usage
+static void PrintUsage(const char *name)
+{
+	printf("usage: %s [-f frames] [-o screen.png] [-s serial.txt] [-b bios.bin] [-k skip] [-r] [-n] [-i] [-u] [-m play.dbm | -w record.dbm] [-c stats.csv] rom.gb\n", name);
+	printf("       %s -l jobs.txt [-j threads]\n", name);
+	printf("       %s --bench [-f frames] [-k skip] [-r] [-n] [-i] [-u] rom.gb [rom.gb ...]\n", name);
+}
+
+// responsible for parsing the command line
+static bool ParseArgs(int argc, char *argv[])
+{
+	static const struct option longOptions[] =
+	{
+		{"bench", no_argument, NULL, 'B'},
+		{NULL, 0, NULL, 0},
+	};
+	int opt;
+
+	while ((opt = getopt_long(argc, argv, "f:o:s:b:l:j:k:rnium:w:c:", longOptions, NULL)) != -1)
+	{
+		switch(opt)
+		{
+			case 'B': benchMode = true; break;
+			case 'f': frameCount = atoi(optarg); break;
+			case 'o': screenPath = optarg; break;
+			case 's': serialPath = optarg; break;
+			case 'b': biosPath = optarg; break;
+			case 'l': jobListPath = optarg; break;
+			case 'j': threadCount = atoi(optarg); break;
+			case 'k': frameSkip = atoi(optarg); break;
+			case 'r': renderEnabled = false; break;
+			case 'n': useBlockCache = false; break;
+			case 'i': useIdleLoops = false; break;
+			case 'u': useFusedOps = false; break;
+			case 'm': playMoviePath = optarg; break;
+			case 'w': recordMoviePath = optarg; break;
+			case 'c': statsPath = optarg; break;
+			default: return false;
+		}
+	}
+
+	if (jobListPath != NULL) return (threadCount >= 0);
+	if (optind >= argc || frameCount <= 0 || frameSkip < 0) return false;
+
+	if (benchMode)
+	{
+		benchRomCount = (argc - optind);
+		benchRoms = &argv[optind];
+		return true;
+	}
+
+	if (playMoviePath != NULL && recordMoviePath != NULL) return false;
+
+	romPath = argv[optind];
+
+	return true;
+}
+
+// responsible for running every job in the job list across the worker pool
+static int RunJobList()
+{
+	WorkerPool pool(threadCount);
+
+	if (!pool.AddJobList(jobListPath)) return 1;
+
+	pool.Run();
+	pool.PrintReport();
+
+	return 0;
+}
+
+// responsible for running the machine for the requested amount of frames
+static long long RunFrames(GameBoy &gameBoy, int frames)
+{
+	long long instructions = 0;
+
+	for (int i = 0; i < frames; i++)
+	{
+		const bool finished = gameBoy.RunFrame();
+
+		instructions += gameBoy.cpu.instructionsRan;
+		gameBoy.cpu.instructionsRan = 0;
+
+		if (!finished)
+		{
+			Log::Critical("Machine stopped after %d frames", i);
+			break;
+		}
+
+		framesRan += 1;
+	}
+
+	return instructions;
+}
+
+// responsible for printing a string as a json string literal
+static void PrintJsonString(const char *str)
+{
+	putchar('"');
+
+	for (const char *c = str; *c != '\0'; c++)
+	{
+		if (*c == '"' || *c == '\\') putchar('\\');
+		putchar(*c);
+	}
+
+	putchar('"');
+}
+
+// responsible for running every rom for the same amount of frames and printing the throughput of each as json
+static int RunBench()
+{
+	// keep stdout for the json
+	Log::Redirect(stderr);
+
+	const bool profiled = Profiler::Available();
+	int totalFrames = 0;
+	long long totalInstructions = 0;
+	long long totalCycles = 0;
+	double totalSeconds = 0;
+	bool failed = false;
+
+	printf("{\n\t\"frames\": %d,\n\t\"frame_skip\": %d,\n\t\"render\": %s,\n\t\"block_cache\": %s,\n\t\"idle_loops\": %s,\n\t\"fused_ops\": %s,\n\t\"profiled\": %s,\n\t\"roms\": [", frameCount, frameSkip, (renderEnabled) ? "true" : "false", (useBlockCache) ? "true" : "false", (useIdleLoops) ? "true" : "false", (useFusedOps) ? "true" : "false", (profiled) ? "true" : "false");
+
+	for (int i = 0; i < benchRomCount; i++)
+	{
+		GameBoy *gameBoy = new GameBoy();
+		gameBoy->memory.serialOutput = NULL;
+		gameBoy->blockCache.enabled = useBlockCache;
+		gameBoy->blockCache.idleLoops = useIdleLoops;
+		gameBoy->blockCache.fuseOps = useFusedOps;
+		gameBoy->lcd.frameSkip = frameSkip;
+		gameBoy->lcd.renderEnabled = renderEnabled;
+
+		printf((i == 0) ? "\n\t\t{\"rom\": " : ",\n\t\t{\"rom\": ");
+		PrintJsonString(benchRoms[i]);
+
+		if (!gameBoy->LoadRom(benchRoms[i]))
+		{
+			printf(", \"failed\": true}");
+			failed = true;
+			delete gameBoy;
+			continue;
+		}
+
+		framesRan = 0;
+		Profiler::Reset();
+		Profiler::Start();
+
+		const long long startCycles = gameBoy->cpu.totalCycles;
+		const auto start = std::chrono::steady_clock::now();
+		const long long instructions = RunFrames(*gameBoy, frameCount);
+		const auto end = std::chrono::steady_clock::now();
+		const double seconds = std::chrono::duration<double>(end - start).count();
+		const long long cycles = (gameBoy->cpu.totalCycles - startCycles);
+
+		Profiler::Stop();
+
+		printf(", \"frames\": %d, \"seconds\": %.6f, \"frames_per_sec\": %.1f, \"instructions_per_sec\": %.0f, \"cycles_per_sec\": %.0f", framesRan, seconds, framesRan / seconds, instructions / seconds, cycles / seconds);
+
+		// the share of the sampled time each section was running for, not counting the sections it called into
+		if (profiled)
+		{
+			const long long samples = Profiler::TotalSamples();
+
+			printf(", \"samples\": %lld, \"sections\": {", samples);
+
+			for (int section = 0; section < Profiler::SECTION_COUNT; section++)
+			{
+				const double share = (samples > 0) ? ((double)Profiler::Samples(section) / samples) : 0;
+
+				printf("%s\"%s\": %.4f", (section == 0) ? "" : ", ", Profiler::Name(section), share);
+			}
+
+			printf("}");
+		}
+
+		printf("}");
+
+		if (framesRan < frameCount) failed = true;
+
+		totalFrames += framesRan;
+		totalInstructions += instructions;
+		totalCycles += cycles;
+		totalSeconds += seconds;
+
+		delete gameBoy;
+	}
+
+	printf("\n\t],\n\t\"total\": {\"frames\": %d, \"seconds\": %.6f", totalFrames, totalSeconds);
+
+	if (totalSeconds > 0) printf(", \"frames_per_sec\": %.1f, \"instructions_per_sec\": %.0f, \"cycles_per_sec\": %.0f", totalFrames / totalSeconds, totalInstructions / totalSeconds, totalCycles / totalSeconds);
+
+	printf("}\n}\n");
+
+	return (failed) ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (!ParseArgs(argc, argv))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	if (jobListPath != NULL) return RunJobList();
+	if (benchMode) return RunBench();
+
+	FILE *serialFile = NULL;
+
+	if (serialPath != NULL)
+	{
+		serialFile = fopen(serialPath, "wb");
+
+		if (serialFile == NULL)
+		{
+			Log::Critical("Failed to open serial output file: '%s'", serialPath);
+			return 1;
+		}
+	}
+
+	GameBoy *gameBoy = new GameBoy();
+	gameBoy->memory.serialOutput = serialFile;
+	gameBoy->blockCache.enabled = useBlockCache;
+	gameBoy->blockCache.idleLoops = useIdleLoops;
+	gameBoy->blockCache.fuseOps = useFusedOps;
+	gameBoy->lcd.frameSkip = frameSkip;
+	gameBoy->lcd.renderEnabled = renderEnabled;
+
+	if (!gameBoy->LoadRom(romPath, biosPath))
+	{
+		if (serialFile != NULL) fclose(serialFile);
+		delete gameBoy;
+		return 1;
+	}
+
+	if (playMoviePath != NULL)
+	{
+		if (!gameBoy->movie.Play(playMoviePath))
+		{
+			if (serialFile != NULL) fclose(serialFile);
+			delete gameBoy;
+			return 1;
+		}
+
+		// a replay runs for as long as the recording did
+		frameCount = gameBoy->movie.FrameCount();
+	}
+
+	if (recordMoviePath != NULL) gameBoy->movie.Record(recordMoviePath);
+
+	const auto start = std::chrono::steady_clock::now();
+	const long long instructions = RunFrames(*gameBoy, frameCount);
+	const auto end = std::chrono::steady_clock::now();
+	const double seconds = std::chrono::duration<double>(end - start).count();
+
+	Log::Print("Ran %d frames in %.3f seconds (%.1f frames/sec, %.0f instructions/sec)", framesRan, seconds, framesRan / seconds, instructions / seconds);
+
+	if (screenPath != NULL)
+	{
+		if (!stbi_write_png(screenPath, 160, 144, 3, gameBoy->lcd.GetScreen(), 160 * 3))
+		{
+			Log::Critical("Failed to write screen to: '%s'", screenPath);
+		}
+	}
+
+	if (statsPath != NULL)
+	{
+		if (Stats::Available()) gameBoy->stats.DumpCsv(statsPath);
+		else Log::Critical("Built without COLLECT_STATS, not writing: '%s'", statsPath);
+	}
+
+	// writes out the recording, if there is one
+	gameBoy->movie.Stop();
+
+	const bool diverged = (gameBoy->movie.divergedFrame >= 0);
+
+	if (serialFile != NULL) fclose(serialFile);
+	delete gameBoy;
+
+	return (diverged) ? 1 : 0;
+}
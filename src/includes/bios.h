@@ -13,14 +13,18 @@
 // includes
 #include "typedefs.h"
 
+class GameBoy;
+
 class Bios
 {
 	public:
-		static bool Load(const char *filePath);
-		static void Reload();
+		Bios(GameBoy &gb);
+		bool Load(const char *filePath);
+		void Reload();
 
 	private:
-		static const char *filename;
+		GameBoy &gb;
+		const char *filename;
 };
 
 #endif
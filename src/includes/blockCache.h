@@ -0,0 +1,69 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+// includes
+#include <vector>
+#include "typedefs.h"
+
+// definitions
+#define BLOCK_MAX_OPS 32
+#define BLOCK_MAX_COUNT 65536
+
+class GameBoy;
+
+// caches runs of pre-decoded opcodes (up to the next jump), keyed by rom bank and pc
+class BlockCache
+{
+	public:
+		struct Op
+		{
+			u16 pc;
+			u16 operand;
+			u8 opcode;
+			// the id of the pair (from opcodesFused.h) this opcode starts along with the next one (0 = none)
+			u8 fused;
+		};
+
+		struct Block
+		{
+			Op ops[BLOCK_MAX_OPS];
+			u8 count;
+			// the block jumps back to its own start and only polls the lcd/interrupt registers in between
+			bool idleLoop;
+		};
+
+	public:
+		BlockCache(GameBoy &gb);
+		const Block *Lookup(u16 pc);
+		void Invalidate(u16 address);
+		void Remap();
+		void Flush();
+
+	private:
+		int GetRegion(u16 pc);
+		int Decode(u16 pc, int region);
+
+	public:
+		static const u8 opcodeLength[256];
+		unsigned int generation;
+		bool enabled;
+		bool idleLoops;
+		bool fuseOps;
+
+	private:
+		GameBoy &gb;
+		std::vector<Block> blocks;
+		std::vector<std::vector<int> > regions;
+		bool codePages[32];
+};
+
+#endif
@@ -12,21 +12,52 @@
 
 // includes
 #include "typedefs.h"
+#include "blockCache.h"
+#include "cpuOperations.h"
+#include "flags.h"
 
 // definitions
 #define MAX_CYCLES 4194304
+#define CPU_DISPATCH_SWITCH 0 // one big switch
+#define CPU_DISPATCH_TABLE 1 // table of per-opcode member functions
+#define CPU_DISPATCH_GOTO 2 // computed goto (GCC/Clang only)
+
+// the opcode dispatch backend is picked at build time (ie. -DCPU_DISPATCH=CPU_DISPATCH_TABLE)
+#ifndef CPU_DISPATCH
+#define CPU_DISPATCH CPU_DISPATCH_SWITCH
+#endif
+
+class GameBoy;
+class StateBuffer;
 
 class Cpu
 {
 	public:
-		static void Init();
-		static void ExecuteOpcode();
-		static void Step();
-		static bool LoadState(bool fromDebugger, unsigned int num = 0);
-		static void SaveState(bool fromDebugger, unsigned int num = 0);
+		Cpu(GameBoy &gb);
+		void Init();
+		void ExecuteOpcode();
+		void Step();
+		bool LoadState(bool fromDebugger, unsigned int num = 0);
+		void SaveState(bool fromDebugger, unsigned int num = 0);
+		void Serialize(StateBuffer &state);
 
 	private:
-		static void ExecuteExtendedOpcode();
+		void ExecuteExtendedOpcode();
+		const BlockCache::Op *NextOp();
+		int HaltedCycles();
+		bool SkipIdleLoop();
+		void UnimplementedOpcode(u8 opcode);
+		void Dispatch(u8 opcode);
+		void DispatchExtended(u8 opcode);
+		void DispatchFused(u8 fused);
+		template <u8 opcode> void Opcode();
+		template <u8 opcode> void OpcodeExtended();
+		template <u8 first, u8 second> void Fused();
+#if CPU_DISPATCH == CPU_DISPATCH_TABLE
+		typedef void (Cpu::*OpcodeHandler)();
+		static const OpcodeHandler opcodeTable[256];
+		static const OpcodeHandler opcodeExtendedTable[256];
+#endif
 
 	public:
 		union Register
@@ -38,20 +69,45 @@ class Cpu
 			};
 		};
 
-		static Register af;
-		static Register bc;
-		static Register de;
-		static Register hl;
-		static Register sp;
-		static Register pc;
-		static int cycles;
-		static int instructionsRan;
-		static int framerate;
-		static bool halted;
-		static bool stopped;
-		static bool pendingInterrupt;
-		static bool haltBug;
-		static bool didLoadBios;
+		Register af;
+		Register bc;
+		Register de;
+		Register hl;
+		Register sp;
+		Register pc;
+		int cycles;
+		int instructionsRan;
+		// every cycle run since the machine started (cycles is reset each frame)
+		long long totalCycles;
+		bool halted;
+		bool stopped;
+		bool pendingInterrupt;
+		bool haltBug;
+		bool didLoadBios;
+		bool stopMachine;
+		Flags flags;
+
+	private:
+		GameBoy &gb;
+		CpuOps ops;
+		u16 operand;
+		const BlockCache::Block *block;
+		u8 blockIndex;
+		unsigned int blockGeneration;
+		// where the cycles were when the current step started
+		int stepStart;
+
+		// the machine as it was the last time the cpu came back around a polling loop
+		struct IdleLoop
+		{
+			long long totalCycles;
+			unsigned int generation;
+			int elapsed;
+			u16 pc;
+			u16 af;
+			u8 io[3];
+			bool valid;
+		} idleLoop;
 };
 
 #endif
@@ -12,66 +12,75 @@
 
 // includes
 #include "typedefs.h"
+#include "flags.h"
 
+class GameBoy;
+
+// the operations every opcode is built from (defined in cpuOperationsTemplates.h)
 class CpuOps
 {
 	public:
-		static void Add8(u8 &in, u8 val, int cycles);
-		static void Adc8(u8 &in, u8 val, int cycles);
-		static void Sub8(u8 &in, u8 val, int cycles);
-		static void Sbc8(u8 &in, u8 val, int cycles);
-		static void Inc8(u8 &in, int cycles);
-		static void Inc8Mem(u16 address, int cycles);
-		static void Dec8(u8 &in, int cycles);
-		static void Dec8Mem(u16 address, int cycles);
-		static void Cmp8(u8 &in, u8 compare, int cycles);
-		static void And8(u8 &in, u8 val, int cycles);
-		static void Or8(u8 &in, u8 val, int cycles);
-		static void Xor8(u8 &in, u8 val, int cycles);
-		static void Rlc8(u8 &in, bool checkZero, int cycles);
-		static void Rlc8Mem(u16 address, bool checkZero, int cycles);
-		static void Rrc8(u8 &in, bool checkZero, int cycles);
-		static void Rrc8Mem(u16 address, bool checkZero, int cycles);
-		static void Rl8(u8 &in, bool checkZero, int cycles);
-		static void Rl8Mem(u16 address, bool checkZero, int cycles);
-		static void Rr8(u8 &in, bool checkZero, int cycles);
-		static void Rr8Mem(u16 address, bool checkZero, int cycles);
-		static void Slc8(u8 &in, int cycles);
-		static void Slc8Mem(u16 address, int cycles);
-		static void Sr8(u8 &in, int cycles);
-		static void Sr8Mem(u16 address, int cycles);
-		static void Src8(u8 &in, int cycles);
-		static void Src8Mem(u16 address, int cycles);
-		static void Daa(int cycles);
-		static void CmplA(int cycles);
-		static void Scf(int cycles);
-		static void Ccf(int cycles);
-		static void BitTest(u8 in, u8 bit, int cycles);
-		static void BitTestMem(u16 address, u8 bit, int cycles);
-		static void BitSet(u8 &in, u8 bit, int cycles);
-		static void BitSetMem(u16 address, u8 bit, int cycles);
-		static void BitClear(u8 &in, u8 bit, int cycles);
-		static void BitClearMem(u16 address, u8 bit, int cycles);
-		static void BitSwap(u8 &in, int cycles);
-		static void BitSwapMem(u16 address, int cycles);
-		static void Load8(u8 &in, u8 val, int cycles);
-		static void Write8(u16 address, u8 data, int cycles);
-		static void Add16(u16 &in, u16 val, int cycles);
-		static void Inc16(u16 &in, int cycles);
-		static void Dec16(u16 &in, int cycles);
-		static void AddSpR8(int cycles);
-		static void Load16(u16 &in, u16 val, int cycles);
-		static void LoadHlSpR8(int cycles);
-		static void JmpRel(bool condition, int cycles);
-		static void JmpImm(bool condition, int cycles);
-		static void Call(bool condition, int cycles);
-		static void Ret(bool condition, int cycles);
-		static void Rst(u16 address, int cycles);
-		static void Nop(int cycles);
-		static void Stop(int cycles);
-		static void Halt(int cycles);
-		static void DI(int cycles);
-		static void EI(int cycles);
+		CpuOps(GameBoy &gb, Flags &flags) : gb(gb), flags(flags) {}
+		template <int cycles> void Add8(u8 &in, u8 val);
+		template <int cycles> void Adc8(u8 &in, u8 val);
+		template <int cycles> void Sub8(u8 &in, u8 val);
+		template <int cycles> void Sbc8(u8 &in, u8 sub);
+		template <int cycles> void Inc8(u8 &in);
+		template <int cycles> void Inc8Mem(u16 address);
+		template <int cycles> void Dec8(u8 &in);
+		template <int cycles> void Dec8Mem(u16 address);
+		template <int cycles> void Cmp8(u8 &in, u8 compare);
+		template <int cycles> void And8(u8 &in, u8 val);
+		template <int cycles> void Or8(u8 &in, u8 val);
+		template <int cycles> void Xor8(u8 &in, u8 val);
+		template <bool checkZero, int cycles> void Rlc8(u8 &in);
+		template <bool checkZero, int cycles> void Rlc8Mem(u16 address);
+		template <bool checkZero, int cycles> void Rrc8(u8 &in);
+		template <bool checkZero, int cycles> void Rrc8Mem(u16 address);
+		template <bool checkZero, int cycles> void Rl8(u8 &in);
+		template <bool checkZero, int cycles> void Rl8Mem(u16 address);
+		template <bool checkZero, int cycles> void Rr8(u8 &in);
+		template <bool checkZero, int cycles> void Rr8Mem(u16 address);
+		template <int cycles> void Slc8(u8 &in);
+		template <int cycles> void Slc8Mem(u16 address);
+		template <int cycles> void Sr8(u8 &in);
+		template <int cycles> void Sr8Mem(u16 address);
+		template <int cycles> void Src8(u8 &in);
+		template <int cycles> void Src8Mem(u16 address);
+		template <int cycles> void Daa();
+		template <int cycles> void CmplA();
+		template <int cycles> void Scf();
+		template <int cycles> void Ccf();
+		template <u8 bit, int cycles> void BitTest(u8 in);
+		template <u8 bit, int cycles> void BitTestMem(u16 address);
+		template <u8 bit, int cycles> void BitSet(u8 &in);
+		template <u8 bit, int cycles> void BitSetMem(u16 address);
+		template <u8 bit, int cycles> void BitClear(u8 &in);
+		template <u8 bit, int cycles> void BitClearMem(u16 address);
+		template <int cycles> void BitSwap(u8 &in);
+		template <int cycles> void BitSwapMem(u16 address);
+		template <int cycles> void Load8(u8 &in, u8 val);
+		template <int cycles> void Write8(u16 address, u8 data);
+		template <int cycles> void Add16(u16 &in, u16 val);
+		template <int cycles> void Inc16(u16 &in);
+		template <int cycles> void Dec16(u16 &in);
+		template <int cycles> void AddSpR8(u8 r8);
+		template <int cycles> void Load16(u16 &in, u16 val);
+		template <int cycles> void LoadHlSpR8(u8 r8);
+		template <int cycles> void JmpRel(bool condition, u8 r8);
+		template <int cycles> void JmpImm(bool condition, u16 address);
+		template <int cycles> void Call(bool condition, u16 address);
+		template <int cycles> void Ret(bool condition);
+		template <u16 address, int cycles> void Rst();
+		template <int cycles> void Nop();
+		template <int cycles> void Stop();
+		template <int cycles> void Halt();
+		template <int cycles> void DI();
+		template <int cycles> void EI();
+
+	private:
+		GameBoy &gb;
+		Flags &flags;
 };
 
 #endif
@@ -0,0 +1,615 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef CPU_OPS_TEMPLATES
+#define CPU_OPS_TEMPLATES
+
+// includes
+#include "bit.h"
+#include "gameboy.h"
+
+// the cpu operations, with every operand that is fixed per opcode (cycles, bit index, zero flag behaviour) as a template argument
+// each opcode in opcodes.h/opcodesExtended.h instantiates its own copy, so it compiles to straight-line code
+// (only cpu.cpp includes this, as the operations need the whole machine)
+
+// # 8 bit operations # //
+
+template <int cycles>
+void CpuOps::Add8(u8 &in, u8 val)
+{
+	flags.Defer(Flags::ADD, in, val);
+
+	in += val;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Adc8(u8 &in, u8 val)
+{
+	const u8 carry = flags.Get(Flags::c);
+
+	flags.Defer(Flags::ADC, in, val, carry);
+
+	in += (carry + val);
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Sub8(u8 &in, u8 val)
+{
+	flags.Defer(Flags::SUB, in, val);
+
+	in -= val;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Sbc8(u8 &in, u8 sub)
+{
+	const u8 carry = flags.Get(Flags::c);
+
+	flags.Defer(Flags::SBC, in, sub, carry);
+
+	in -= (carry + sub);
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Inc8(u8 &in)
+{
+	flags.Defer(Flags::INC, in, 1);
+
+	in += 1;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Inc8Mem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	Inc8<cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <int cycles>
+void CpuOps::Dec8(u8 &in)
+{
+	flags.Defer(Flags::DEC, in, 1);
+
+	in -= 1;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Dec8Mem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	Dec8<cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <int cycles>
+void CpuOps::Cmp8(u8 &in, u8 compare)
+{
+	flags.Defer(Flags::SUB, in, compare);
+
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::And8(u8 &in, u8 val)
+{
+	flags.Defer(Flags::AND, in, val);
+
+	in &= val;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Or8(u8 &in, u8 val)
+{
+	in |= val;
+
+	flags.Defer(Flags::OR, in, 0);
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Xor8(u8 &in, u8 val)
+{
+	in ^= val;
+
+	flags.Defer(Flags::OR, in, 0);
+	gb.cpu.cycles += cycles;
+}
+
+template <bool checkZero, int cycles>
+void CpuOps::Rlc8(u8 &in)
+{
+	const u8 result = ((in << 1) | (in >> 7));
+
+	flags.Clear(Flags::all);
+
+	if (checkZero && (result == 0)) flags.Set(Flags::z);
+	if (in & 0x80) flags.Set(Flags::c);
+
+	in = result;
+	gb.cpu.cycles += cycles;
+}
+
+template <bool checkZero, int cycles>
+void CpuOps::Rlc8Mem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	Rlc8<checkZero, cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <bool checkZero, int cycles>
+void CpuOps::Rrc8(u8 &in)
+{
+	const u8 result = ((in >> 1) | (in << 7));
+
+	flags.Clear(Flags::all);
+
+	if (checkZero && (result == 0)) flags.Set(Flags::z);
+	if (in & 0x01) flags.Set(Flags::c);
+
+	in = result;
+	gb.cpu.cycles += cycles;
+}
+
+template <bool checkZero, int cycles>
+void CpuOps::Rrc8Mem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	Rrc8<checkZero, cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <bool checkZero, int cycles>
+void CpuOps::Rl8(u8 &in)
+{
+	const u8 carry = flags.Get(Flags::c);
+	const u8 result = ((in << 1) | (carry));
+
+	flags.Clear(Flags::all);
+
+	if (checkZero && (result == 0)) flags.Set(Flags::z);
+	if (in & 0x80) flags.Set(Flags::c);
+
+	in = result;
+	gb.cpu.cycles += cycles;
+}
+
+template <bool checkZero, int cycles>
+void CpuOps::Rl8Mem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	Rl8<checkZero, cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <bool checkZero, int cycles>
+void CpuOps::Rr8(u8 &in)
+{
+	const u8 carry = flags.Get(Flags::c);
+	const u8 result = ((in >> 1) | (carry << 7));
+
+	flags.Clear(Flags::all);
+
+	if (checkZero && (result == 0)) flags.Set(Flags::z);
+	if (in & 0x01) flags.Set(Flags::c);
+
+	in = result;
+	gb.cpu.cycles += cycles;
+}
+
+template <bool checkZero, int cycles>
+void CpuOps::Rr8Mem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	Rr8<checkZero, cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <int cycles>
+void CpuOps::Slc8(u8 &in)
+{
+	const u8 result = (in << 1);
+
+	flags.Clear(Flags::all);
+
+	if (result == 0) flags.Set(Flags::z);
+	if (in & 0x80) flags.Set(Flags::c);
+
+	in = result;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Slc8Mem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	Slc8<cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <int cycles>
+void CpuOps::Sr8(u8 &in)
+{
+	const u8 result = (in >> 1);
+	const u8 oldMsb = (in & 0x80);
+
+	flags.Clear(Flags::all);
+
+	if (result == 0) flags.Set(Flags::z);
+	if (in & 0x01) flags.Set(Flags::c);
+
+	// the sign bit stays where it was
+	in = (result | oldMsb);
+
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Sr8Mem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	Sr8<cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <int cycles>
+void CpuOps::Src8(u8 &in)
+{
+	const u8 result = (in >> 1);
+
+	flags.Clear(Flags::all);
+
+	if (result == 0) flags.Set(Flags::z);
+	if (in & 0x01) flags.Set(Flags::c);
+
+	in = result;
+
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Src8Mem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	Src8<cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <int cycles>
+void CpuOps::Daa()
+{
+	flags.Daa(gb.cpu.af.hi);
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::CmplA()
+{
+	flags.Set(Flags::n | Flags::h);
+
+	gb.cpu.af.hi ^= 0xFF;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Scf()
+{
+	flags.Clear(Flags::n | Flags::h);
+	flags.Set(Flags::c);
+
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Ccf()
+{
+	flags.Clear(Flags::n | Flags::h);
+
+	if (flags.Get(Flags::c)) flags.Clear(Flags::c); else flags.Set(Flags::c);
+
+	gb.cpu.cycles += cycles;
+}
+
+template <u8 bit, int cycles>
+void CpuOps::BitTest(u8 in)
+{
+	flags.Clear(Flags::z | Flags::n);
+	flags.Set(Flags::h);
+
+	if (!(in & (1 << bit))) flags.Set(Flags::z);
+
+	gb.cpu.cycles += cycles;
+}
+
+template <u8 bit, int cycles>
+void CpuOps::BitTestMem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	BitTest<bit, cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <u8 bit, int cycles>
+void CpuOps::BitSet(u8 &in)
+{
+	in |= (1 << bit);
+	gb.cpu.cycles += cycles;
+}
+
+template <u8 bit, int cycles>
+void CpuOps::BitSetMem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	BitSet<bit, cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <u8 bit, int cycles>
+void CpuOps::BitClear(u8 &in)
+{
+	in &= ~(1 << bit);
+	gb.cpu.cycles += cycles;
+}
+
+template <u8 bit, int cycles>
+void CpuOps::BitClearMem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	BitClear<bit, cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <int cycles>
+void CpuOps::BitSwap(u8 &in)
+{
+	const u8 result = (((in & 0xF0) >> 4) | ((in & 0x0F) << 4));
+
+	flags.Clear(Flags::all);
+
+	if (result == 0) flags.Set(Flags::z);
+
+	in = result;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::BitSwapMem(u16 address)
+{
+	u8 data = gb.memory.ReadByte(address);
+
+	BitSwap<cycles>(data);
+	gb.memory.WriteByte(address, data);
+}
+
+template <int cycles>
+void CpuOps::Load8(u8 &in, u8 val)
+{
+	in = val;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Write8(u16 address, u8 data)
+{
+	gb.memory.WriteByte(address, data);
+	gb.cpu.cycles += cycles;
+}
+
+// # 16 bit operations # //
+
+template <int cycles>
+void CpuOps::Add16(u16 &in, u16 val)
+{
+	const u16 result = (in + val);
+
+	flags.Clear(Flags::n | Flags::h | Flags::c);
+
+	if (Bit::DidHalfCarry(in, val, 0xFFF)) flags.Set(Flags::h);
+	if (Bit::DidCarry((int)(in + val), 0xFFFF)) flags.Set(Flags::c);
+
+	in = result;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Inc16(u16 &in)
+{
+	in += 1;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Dec16(u16 &in)
+{
+	in -= 1;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::AddSpR8(u8 r8)
+{
+	flags.Clear(Flags::all);
+
+	if (Bit::DidHalfCarry(gb.cpu.sp.lo, r8, 0xF)) flags.Set(Flags::h);
+	if (Bit::DidCarry(gb.cpu.sp.lo + r8, 0xFF)) flags.Set(Flags::c);
+
+	gb.cpu.sp.reg =  (gb.cpu.sp.reg + (s8)r8);
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Load16(u16 &in, u16 val)
+{
+	in = val;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::LoadHlSpR8(u8 r8)
+{
+	flags.Clear(Flags::all);
+
+	if (Bit::DidHalfCarry(gb.cpu.sp.lo, r8, 0xF)) flags.Set(Flags::h);
+	if (Bit::DidCarry(gb.cpu.sp.lo + r8, 0xFF)) flags.Set(Flags::c);
+
+	gb.cpu.hl.reg = (gb.cpu.sp.reg + (s8)r8);
+	gb.cpu.cycles += cycles;
+}
+
+// # flow control # //
+
+template <int cycles>
+void CpuOps::JmpRel(bool condition, u8 r8)
+{
+	if (condition)
+	{
+		gb.cpu.pc.reg += (s8)r8;
+		gb.cpu.cycles += 4;
+	}
+
+	gb.cpu.pc.reg += 1;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::JmpImm(bool condition, u16 address)
+{
+	if (condition)
+	{
+		gb.cpu.pc.reg = address;
+		gb.cpu.cycles += (cycles + 4);
+		return;
+	}
+
+	gb.cpu.pc.reg += 2;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Call(bool condition, u16 address)
+{
+	if (condition)
+	{
+		gb.cpu.pc.reg += 2;
+		gb.memory.Push(gb.cpu.pc);
+		gb.cpu.pc.reg = address;
+		gb.cpu.cycles += (cycles + 12);
+		return;
+	}
+
+	gb.cpu.pc.reg += 2;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Ret(bool condition)
+{
+	if (condition)
+	{
+		gb.cpu.pc.reg = gb.memory.Pop();
+		gb.cpu.cycles += 12;
+	}
+
+	gb.cpu.cycles += cycles;
+}
+
+template <u16 address, int cycles>
+void CpuOps::Rst()
+{
+	gb.memory.Push(gb.cpu.pc);
+
+	gb.cpu.pc.reg = address;
+	gb.cpu.cycles += cycles;
+}
+
+// # misc # //
+
+template <int cycles>
+void CpuOps::Nop()
+{
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Stop()
+{
+	gb.cpu.stopped = true;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::Halt()
+{
+	const u8 IF = gb.memory.ReadByte(Memory::Address::IF);
+	const u8 IE = gb.memory.ReadByte(Memory::Address::IE);
+
+	if (!gb.interrupts.ime)
+	{
+		// HALT mode is entered. It works like the IME = 1 case
+		if (((IE & IF) & 0x1F) == 0)
+		{
+			gb.cpu.halted = true;
+			gb.interrupts.clearIF = false;
+			gb.interrupts.shouldExecute = false;
+		}
+		// HALT mode is not entered. HALT bug occurs
+		else
+		{
+			gb.interrupts.clearIF = false;
+			gb.interrupts.shouldExecute = true;
+			gb.cpu.halted = false;
+			gb.cpu.haltBug = true;
+		}
+	}
+	// HALT executed normally
+	else
+	{
+		gb.cpu.halted = true;
+		gb.interrupts.clearIF = true;
+		gb.interrupts.shouldExecute = true;
+	}
+
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::DI()
+{
+	gb.interrupts.ime = false;
+	gb.cpu.cycles += cycles;
+}
+
+template <int cycles>
+void CpuOps::EI()
+{
+	gb.cpu.pendingInterrupt = true;
+	gb.cpu.cycles += cycles;
+}
+
+#endif
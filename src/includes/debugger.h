@@ -13,12 +13,15 @@
 // includes
 #include "typedefs.h"
 
+class GameBoy;
+
 // definitions
 #define USE_DEBUGGER 1
 
 class Debugger
 {
 	public:
+		static void Init(GameBoy *gameBoy);
 		static void ResetSystem(bool reloadRom = false);
 		static void SaveScreenshot();
 		static void ShowDebugger();
@@ -29,17 +32,19 @@ class Debugger
 		static void SetMemoryValuePopup();
 		static void DumpMemory();
 		static void ImportMemory();
+		static void DumpStats();
 		static void RomInfoPopup();
 		static void ModifyRegistersPopup();
 		static void SetBreakpointPopup();
 		static void MemoryViewerWindow(const char *title, int width, int height, int x, int y);
 		static void RegisterViewerWindow(const char *title, int width, int height, int x, int y);
+		static void StatsWindow(const char *title);
 
 	public:
 		static bool stepThrough;
 		static bool stopAtBreakpoint;
 		static bool active;
-		static bool stopMachine;
+		static bool showStats;
 		static u16 breakpoint;
 		static const char *modifyRegistersPopupTitle;
 		static const char *memViewPopupTitle;
@@ -0,0 +1,28 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+// includes
+#include "typedefs.h"
+
+class Display
+{
+	public:
+		static void Init();
+		static void UpdateTexture(const u8 *screen);
+		static void Render();
+
+	public:
+		static int height;
+		static int width;
+};
+
+#endif
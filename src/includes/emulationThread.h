@@ -0,0 +1,69 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef EMULATION_THREAD_H
+#define EMULATION_THREAD_H
+
+// includes
+#include "stats.h"
+#include "typedefs.h"
+
+class GameBoy;
+
+// runs the GameBoy on its own thread, so the render thread never stalls emulation
+class EmulationThread
+{
+	public:
+		static void Start(GameBoy *gameBoy);
+		static void Shutdown();
+		static void Lock();
+		static void Unlock();
+		static void SendCommand(u8 command);
+		static const u8 *AcquireFrame();
+		static void AcquireSnapshot();
+		static int TakeFrameCount();
+
+	public:
+		// what the ui shows of the machine, copied out between frames so the ui never has to hold the machine
+		struct Snapshot
+		{
+			Snapshot(GameBoy &gb) : stats(gb) {}
+
+			u16 af, bc, de, hl, sp, pc;
+			int instructionsRan;
+			bool ime;
+			bool romLoaded;
+			bool recording;
+			bool playing;
+			u8 mem[0x10000];
+			Stats stats;
+		};
+
+		static Snapshot &GetSnapshot();
+
+	private:
+		static void Run();
+		static void ProcessCommands();
+		static bool EmulateFrame();
+		static void PublishFrame();
+		static void FillSnapshot(Snapshot &snapshot);
+		static void PublishSnapshot();
+
+	public:
+		enum
+		{
+			Resume, Pause, TogglePause, StepForward, StepBackward,
+			// resume/pause and forget the breakpoint
+			ResumeNoBreak, PauseNoBreak,
+			// reset the machine, or reset it and reload the rom
+			Reset, Restart,
+		};
+};
+
+#endif
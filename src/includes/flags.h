@@ -13,12 +13,21 @@
 // includes
 #include "typedefs.h"
 
+// the F register, where the 8 bit alu only records its operands and leaves the flags to be worked out when read
 class Flags
 {
 	public:
-		static u8 Get(u8 flag);
-		static void Set(u8 flags);
-		static void Clear(u8 flags);
+		enum Operation { NONE, ADD, ADC, SUB, SBC, INC, DEC, AND, OR };
+
+	public:
+		Flags(u8 &f);
+		u8 Get(u8 flag);
+		void Set(u8 flags);
+		void Clear(u8 flags);
+		void Defer(u8 operation, u8 lhs, u8 rhs, u8 carry = 0);
+		void Resolve();
+		void Daa(u8 &a);
+		void Discard();
 
 	public:
 		static const u8 z;
@@ -26,6 +35,13 @@ class Flags
 		static const u8 h;
 		static const u8 c;
 		static const u8 all;
+
+	private:
+		u8 &f;
+		u8 operation;
+		u8 lhs;
+		u8 rhs;
+		u8 carry;
 };
 
 #endif
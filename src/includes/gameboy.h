@@ -0,0 +1,83 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef GAMEBOY_H
+#define GAMEBOY_H
+
+// includes
+#include "typedefs.h"
+#include "bios.h"
+#include "blockCache.h"
+#include "cpu.h"
+#include "input.h"
+#include "interrupts.h"
+#include "lcd.h"
+#include "mbc.h"
+#include "memory.h"
+#include "movie.h"
+#include "rewind.h"
+#include "rom.h"
+#include "scheduler.h"
+#include "stateBuffer.h"
+#include "stats.h"
+#include "timer.h"
+
+// definitions
+#define STATE_MAGIC "DBST"
+// bump whenever the layout of a save state changes, older states are then refused
+#define STATE_VERSION 2
+
+// owns every piece of machine state, so a process can run as many GameBoys as it likes
+class GameBoy
+{
+	public:
+		GameBoy();
+		bool LoadRom(const char *romPath, const char *biosPath = NULL);
+		void Init();
+		void Reset(bool reloadRom = false);
+		bool RunFrame();
+		size_t StateSize();
+		size_t SaveState(u8 *buffer, size_t size);
+		bool LoadState(const u8 *buffer, size_t size);
+
+	private:
+		struct StateHeader
+		{
+			char magic[4];
+			u16 version;
+			// the rom's global checksum, so a state can't be loaded into a different game
+			u16 romChecksum;
+			unsigned int size;
+		};
+
+		void Serialize(StateBuffer &state);
+		u16 RomChecksum();
+
+	private:
+		GameBoy(const GameBoy &);
+		GameBoy &operator=(const GameBoy &);
+
+	public:
+		Cpu cpu;
+		Memory memory;
+		Rom rom;
+		Mbc mbc;
+		Lcd lcd;
+		Timer timer;
+		Interrupts interrupts;
+		Input input;
+		Bios bios;
+		BlockCache blockCache;
+		Scheduler scheduler;
+		Rewind rewind;
+		Movie movie;
+		Stats stats;
+};
+
+#endif
@@ -11,23 +11,60 @@
 #define INPUT_H
 
 // includes
-#include <SDL2/SDL.h>
+#include "spscQueue.h"
 #include "typedefs.h"
 
+// definitions
+#define P15 5 // buttons
+#define P14 4 // directional keys
+#define BTN_START 7
+#define BTN_SELECT 6
+#define BTN_B 5
+#define BTN_A 4
+#define DIR_DOWN 3
+#define DIR_UP 2
+#define DIR_LEFT 1
+#define DIR_RIGHT 0
+#define INPUT_QUEUE_SIZE 64
+
+// the SDL event handling lives in inputEvents.cpp, so the core doesn't depend on SDL
+union SDL_Event;
+class GameBoy;
+class StateBuffer;
+
 class Input
 {
 	public:
-		static void Init();
-		static void HandleKeys(SDL_Event event);
-		static u8 GetKey(u8 data);
+		Input(GameBoy &gb);
+		void Init();
+		void HandleKeys(const SDL_Event &event);
+		void SetKey(u8 bit, bool pressed);
+		void QueueKey(u8 bit, bool pressed);
+		void ProcessQueuedKeys();
+		bool HoldKeys();
+		void SetButtons(u8 mask);
+		u8 GetKey(u8 data);
+		void Serialize(StateBuffer &state);
+
+	private:
+		void PressDirection(u8 bit, u8 keyType);
+		void PressButton(u8 bit, u8 keyType);
+		void ReleaseKey(u8 bit);
 
 	private:
-		static void PressDirection(u8 bit, u8 keyType);
-		static void PressButton(u8 bit, u8 keyType);
-		static void ReleaseKey(u8 bit);
+		struct KeyEvent
+		{
+			u8 key;
+			bool pressed;
+		};
 
 	private:
-		static u8 buttons;
+		GameBoy &gb;
+		u8 buttons;
+		// the keys the frontend has down, which loading an older state doesn't take back
+		u8 held;
+		// key events from the frontend thread, applied by the emulation thread
+		SpscQueue<KeyEvent, INPUT_QUEUE_SIZE> keyQueue;
 };
 
 #endif
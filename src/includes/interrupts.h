@@ -13,28 +13,37 @@
 // includes
 #include "typedefs.h"
 
+class GameBoy;
+class StateBuffer;
+
 class Interrupts
 {
 	public:
-		static void Init();
-		static void Request(int id);
-		static void Service();
+		Interrupts(GameBoy &gb);
+		void Init();
+		void Request(int id);
+		void Service();
+		void Serialize(StateBuffer &state);
 
 	private:
-		static bool IsRequested(int id);
-		static bool IsEnabled(int id);
-		static void Reset(int id);
-		static int RequestedId();
+		bool IsRequested(int id);
+		bool IsEnabled(int id);
+		void Reset(int id);
+		int RequestedId();
 
 	public:
 		enum
 		{
 			VBLANK, LCD, TIMER, SERIAL, JOYPAD
 		};
-		static bool ime;
-		static bool clearIF;
-		static bool shouldExecute;
-		static u8 pendingCount;
+		bool ime;
+		bool clearIF;
+		bool shouldExecute;
+		u8 pendingCount;
+
+	private:
+		GameBoy &gb;
+		bool wasHalted;
 };
 
 #endif
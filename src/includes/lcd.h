@@ -13,36 +13,73 @@
 // includes
 #include "typedefs.h"
 
+// definitions
+#define LCD_FRAME_CYCLES 70224
+#define LCD_MAX_LINE_SPRITES 10
+
+class GameBoy;
+class StateBuffer;
+
 class Lcd
 {
 	public:
-		static void Init();
-		static void Reset();
-		static bool Enabled();
-		static void Update(int cycles);
-		static void Render();
-		static void UpdateTexture();
+		Lcd(GameBoy &gb);
+		void Init();
+		void Reset();
+		bool Enabled();
+		void Update(int cycles);
+		void Advance(int cycles);
+		int NextEvent();
+		void InvalidateTile(u16 address);
+		void FlushTiles();
+		void InvalidateOam();
+		const u8 *GetScreen();
+		const u8 *GetFrameBuffer();
+		void Serialize(StateBuffer &state);
 
 	public:
 		struct Rgb
 		{
 			u8 r, g, b;
 		};
-		static int height;
-		static int width;
-		static u8 screen[144][160][3];
-		static int scanlineCounter;
+		int scanlineCounter;
+		bool frameReady;
+		int frameSkip;
+		bool renderEnabled;
+
+	private:
+		u8 GetMode();
+		u8 SetMode(u8 mode);
+		void SetStatus();
+		bool IsBackgroundEnabled();
+		bool IsWindowEnabled();
+		bool IsSpritesEnabled();
+		void UpdatePalettes();
+		u16 DecodeTileRow(u8 lo, u8 hi);
+		const u8 *GetTileRow(int tile, u8 row, bool xFlip);
+		void DrawScanline();
+		void DrawBackground();
+		void DrawTiles(int start, int end, u16 tileMemory, u8 yPos, u8 xOffset);
+		void IndexSprites(u8 spriteHeight);
+		void DrawSprites();
 
 	private:
-		static u8 SetMode(u8 mode);
-		static void SetStatus();
-		static bool IsBackgroundEnabled();
-		static bool IsWindowEnabled();
-		static bool IsSpritesEnabled();
-		static Rgb GetColor(u8 palette, u8 bit);
-		static void DrawScanline();
-		static void DrawBackground();
-		static void DrawSprites();
+		bool running;
+		bool drawing;
+		int skippedFrames;
+		int paletteValues[3];
+		u8 paletteShades[3][4];
+		u8 frameBuffer[144][160];
+		u8 backgroundColors[160];
+		u8 screen[144][160][3];
+		bool screenDirty;
+		u8 tileCache[2][384][8][8];
+		bool tileDirty[384];
+		u8 lineSprites[144][LCD_MAX_LINE_SPRITES];
+		u8 lineSpriteCount[144];
+		u8 indexedSpriteHeight;
+		bool oamDirty;
+		GameBoy &gb;
 };
 
 #endif
@@ -18,6 +18,7 @@ class Log
 	public:
 		static void Init();
 		static void Close();
+		static void Redirect(FILE *stream);
 		static void Print(const char *fmt, ...);
 		static void Critical(const char *fmt, ...);
 		static void ToFile(const char *str);
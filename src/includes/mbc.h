@@ -12,16 +12,22 @@
 
 // includes
 #include "typedefs.h"
+#include "mbc1.h"
+
+class GameBoy;
 
 class Mbc
 {
 	public:
-		static u16 GetMaxBankSize();
-		static void RomBanking(u16 address, u8 data);
-		static void ManageBanking(u16 address, u8 data);
+		Mbc(GameBoy &gb);
+		u16 GetMaxBankSize();
+		void RomBanking(u16 address, u8 data);
+		void ManageBanking(u16 address, u8 data);
 
 	private:
 		static const u16 maxSize[0x9];
+		GameBoy &gb;
+		Mbc1 mbc1;
 };
 
 #endif
@@ -13,12 +13,18 @@
 // includes
 #include "typedefs.h"
 
+class GameBoy;
+
 class Mbc2
 {
 	public:
-		static void RomBanking(u16 address, u8 data);
-		static void ManageSelection(u8 data);
-		static void ManageMode(u8 data);
+		Mbc2(GameBoy &gb);
+		void RomBanking(u16 address, u8 data);
+		void ManageSelection(u8 data);
+		void ManageMode(u8 data);
+
+	private:
+		GameBoy &gb;
 };
 
 #endif
@@ -14,21 +14,37 @@
 #include "typedefs.h"
 #include "cpu.h"
 
+class GameBoy;
+class StateBuffer;
+
 class Memory
 {
 	public:
-		static void Init();
-		static u8 ReadByte(u16 address);
-		static u16 ReadWord(u16 address);
-		static void WriteByte(u16 address, u8 data);
-		static void WriteWord(u16 address, Cpu::Register reg);
-		static u16 Pop();
-		static void Push(Cpu::Register reg);
+		Memory(GameBoy &gb);
+		void Init();
+		void MapPages();
+		void CopyMap(u8 *out);
+		u8 ReadByte(u16 address);
+		u16 ReadWord(u16 address);
+		u8 PeekByte(u16 address);
+		u16 PeekWord(u16 address);
+		void WriteByte(u16 address, u8 data);
+		void WriteWord(u16 address, Cpu::Register reg);
+		u16 Pop();
+		void Push(Cpu::Register reg);
+		void Serialize(StateBuffer &state);
+		void InvalidateCaches(u16 address);
 
 	public:
-		static u8 mem[0x10000];
-		static bool useRomBank;
-		static bool useRamBank;
+		u8 mem[0x10000];
+		bool useRomBank;
+		bool useRamBank;
+		FILE *serialOutput;
+
+	private:
+		GameBoy &gb;
+		const u8 *readPages[0x100];
+		u8 *writePages[0x100];
 
 	public:
 		class Address
@@ -72,10 +88,14 @@ class Memory
 				static const u16 NR50 = 0xFF24;
 				static const u16 NR51 = 0xFF25;
 				static const u16 NR52 = 0xFF26;
+				static const u16 TILE_DATA_START = 0x8000;
+				static const u16 TILE_DATA_END = 0x97FF;
 				static const u16 WRAM_START = 0xC000;
 				static const u16 WRAM_END = 0xDDFF;
 				static const u16 ERAM_START = 0xE000;
 				static const u16 ERAM_END = 0xFDFF;
+				static const u16 OAM_START = 0xFE00;
+				static const u16 OAM_END = 0xFE9F;
 				static const u16 PROT_MEM_START = 0xFEA0;
 				static const u16 PROT_MEM_END = 0xFEFF;
 				static const u16 HRAM_START = 0xFF80;
@@ -0,0 +1,83 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef MOVIE_H
+#define MOVIE_H
+
+// includes
+#include <string>
+#include <vector>
+#include "typedefs.h"
+
+// definitions
+#define MOVIE_MAGIC "DBMV"
+// bump whenever the layout of a movie changes, older movies are then refused
+#define MOVIE_VERSION 2
+// set when the recording had every frame drawn, so the screen hashes mean something
+#define MOVIE_SCREEN_HASHED 0x01
+
+class GameBoy;
+class StateBuffer;
+
+// records a run as a starting state plus every key press/release (and the frame it came before), with hashes to catch a replay drifting away from it
+class Movie
+{
+	public:
+		Movie(GameBoy &gb);
+		bool Record(const char *filePath);
+		bool Play(const char *filePath);
+		void Stop();
+		void BeginFrame();
+		void EndFrame();
+		void RecordKey(u8 key, bool pressed);
+		bool IsRecording();
+		bool IsPlaying();
+		int FrameCount();
+
+	private:
+		struct Frame
+		{
+			unsigned int ramHash;
+			unsigned int screenHash;
+		};
+
+		// a key change, applied at the start of the frame (a press and release between two frames each request the joypad interrupt)
+		struct KeyEvent
+		{
+			unsigned int frame;
+			u8 key;
+			u8 pressed;
+		};
+
+		bool Serialize(StateBuffer &state);
+		bool ScreenHashed();
+		unsigned int HashRam();
+		unsigned int HashScreen();
+
+	public:
+		// the frame being recorded/played
+		int frame;
+		// the first frame the replay didn't match the recording on (-1 if it hasn't happened)
+		int divergedFrame;
+
+	private:
+		GameBoy &gb;
+		bool recording;
+		bool playing;
+		unsigned int flags;
+		std::string path;
+		std::vector<u8> startState;
+		std::vector<Frame> frames;
+		// in frame order
+		std::vector<KeyEvent> keyEvents;
+		// the next key event to apply while playing
+		size_t nextEvent;
+};
+
+#endif
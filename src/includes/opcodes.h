@@ -0,0 +1,269 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// every opcode, in order, as OPCODE(opcode, body) entries
+// cpu.cpp defines OPCODE before including this list, once per dispatch backend (so there is no include guard)
+// IMM8/IMM16 are the immediate operand, fetched (or pre-decoded by the block cache) before the opcode runs
+
+OPCODE(0x00, ops.Nop<4>();) // NOP
+OPCODE(0x01, ops.Load16<12>(BC, IMM16); PC += 2;) // LD BC,d16
+OPCODE(0x02, ops.Write8<8>(BC, A);) // LD (BC),A
+OPCODE(0x03, ops.Inc16<8>(BC);) // INC BC
+OPCODE(0x04, ops.Inc8<4>(B);) // INC B
+OPCODE(0x05, ops.Dec8<4>(B);) // DEC B
+OPCODE(0x06, ops.Load8<8>(B, IMM8); PC += 1;) // LD B,d8
+OPCODE(0x07, ops.Rlc8<false, 4>(A);) // RLCA
+OPCODE(0x08, gb.memory.WriteWord(IMM16, sp); PC += 2; cycles += 20;) // LD (a16),SP
+OPCODE(0x09, ops.Add16<8>(HL, BC);) // ADD HL,BC
+OPCODE(0x0A, ops.Load8<8>(A, gb.memory.ReadByte(BC));) // LD A,(BC)
+OPCODE(0x0B, ops.Dec16<8>(BC);) // DEC BC
+OPCODE(0x0C, ops.Inc8<4>(C);) // INC C
+OPCODE(0x0D, ops.Dec8<4>(C);) // DEC C
+OPCODE(0x0E, ops.Load8<8>(C, IMM8); PC += 1;) // LD C,d8
+OPCODE(0x0F, ops.Rrc8<false, 4>(A);) // RRCA
+OPCODE(0x10, ops.Stop<4>();) // STOP
+OPCODE(0x11, ops.Load16<12>(DE, IMM16); PC += 2;) // LD DE,d16
+OPCODE(0x12, ops.Write8<8>(DE, A);) // LD (DE),A
+OPCODE(0x13, ops.Inc16<8>(DE);) // INC DE
+OPCODE(0x14, ops.Inc8<4>(D);) // INC D
+OPCODE(0x15, ops.Dec8<4>(D);) // DEC D
+OPCODE(0x16, ops.Load8<8>(D, IMM8); PC += 1;) // LD D,d8
+OPCODE(0x17, ops.Rl8<false, 4>(A);) // RLA
+OPCODE(0x18, ops.JmpRel<8>(true, IMM8);) // JR r8
+OPCODE(0x19, ops.Add16<8>(HL, DE);) // ADD HL,DE
+OPCODE(0x1A, ops.Load8<8>(A, gb.memory.ReadByte(DE));) // LD A,(DE)
+OPCODE(0x1B, ops.Dec16<8>(DE);) // DEC DE
+OPCODE(0x1C, ops.Inc8<4>(E);) // INC E
+OPCODE(0x1D, ops.Dec8<4>(E);) // DEC E
+OPCODE(0x1E, ops.Load8<8>(E, IMM8); PC += 1;) // LD E,d8
+OPCODE(0x1F, ops.Rr8<false, 4>(A);) // RRA
+OPCODE(0x20, ops.JmpRel<8>(!flags.Get(Flags::z), IMM8);) // JR NZ,r8
+OPCODE(0x21, ops.Load16<12>(HL, IMM16); PC += 2;) // LD HL,d16
+OPCODE(0x22, ops.Write8<8>(HL, A); HL += 1;) // LD (HL+),A
+OPCODE(0x23, ops.Inc16<8>(HL);) // INC HL
+OPCODE(0x24, ops.Inc8<4>(H);) // INC H
+OPCODE(0x25, ops.Dec8<4>(H);) // DEC H
+OPCODE(0x26, ops.Load8<8>(H, IMM8); PC += 1;) // LD H,d8
+OPCODE(0x27, ops.Daa<4>();) // DAA
+OPCODE(0x28, ops.JmpRel<8>(flags.Get(Flags::z), IMM8);) // JR Z,r8
+OPCODE(0x29, ops.Add16<8>(HL, HL);) // ADD HL,HL
+OPCODE(0x2A, ops.Load8<12>(A, gb.memory.ReadByte(HL)); HL += 1;) // LD A,(HL+)
+OPCODE(0x2B, ops.Dec16<8>(HL);) // DEC HL
+OPCODE(0x2C, ops.Inc8<4>(L);) // INC L
+OPCODE(0x2D, ops.Dec8<4>(L);) // DEC L
+OPCODE(0x2E, ops.Load8<8>(L, IMM8); PC += 1;) // LD L,d8
+OPCODE(0x2F, ops.CmplA<4>();) // CPL A
+OPCODE(0x30, ops.JmpRel<8>(!flags.Get(Flags::c), IMM8);) // JR NC,r8
+OPCODE(0x31, ops.Load16<12>(SP, IMM16); PC += 2;) // LD SP,d16
+OPCODE(0x32, ops.Write8<8>(HL, A); HL -= 1;) // LD (HL-),A
+OPCODE(0x33, ops.Inc16<8>(SP);) // INC SP
+OPCODE(0x34, ops.Inc8Mem<12>(HL);) // INC (HL)
+OPCODE(0x35, ops.Dec8Mem<12>(HL);) // DEC (HL)
+OPCODE(0x36, ops.Write8<12>(HL, IMM8); PC += 1;) // LD (HL),d8
+OPCODE(0x37, ops.Scf<4>();) // SCF
+OPCODE(0x38, ops.JmpRel<8>(flags.Get(Flags::c), IMM8);) // JR C,r8
+OPCODE(0x39, ops.Add16<8>(HL, SP);) // ADD HL,SP
+OPCODE(0x3A, ops.Load8<8>(A, gb.memory.ReadByte(HL)); HL -= 1;) // LD A,(HL-)
+OPCODE(0x3B, ops.Dec16<8>(SP);) // DEC SP
+OPCODE(0x3C, ops.Inc8<4>(A);) // INC A
+OPCODE(0x3D, ops.Dec8<4>(A);) // DEC A
+OPCODE(0x3E, ops.Load8<8>(A, IMM8); PC += 1;) // LD A,d8
+OPCODE(0x3F, ops.Ccf<4>();) // CCF
+OPCODE(0x40, ops.Load8<4>(B, B);) // LD B,B
+OPCODE(0x41, ops.Load8<4>(B, C);) // LD B,C
+OPCODE(0x42, ops.Load8<4>(B, D);) // LD B,D
+OPCODE(0x43, ops.Load8<4>(B, E);) // LD B,E
+OPCODE(0x44, ops.Load8<4>(B, H);) // LD B,H
+OPCODE(0x45, ops.Load8<4>(B, L);) // LD B,L
+OPCODE(0x46, ops.Load8<8>(B, gb.memory.ReadByte(HL));) // LD B,(HL)
+OPCODE(0x47, ops.Load8<4>(B, A);) // LD B,A
+OPCODE(0x48, ops.Load8<4>(C, B);) // LD C,B
+OPCODE(0x49, ops.Load8<4>(C, C);) // LD C,C
+OPCODE(0x4A, ops.Load8<4>(C, D);) // LD C,D
+OPCODE(0x4B, ops.Load8<4>(C, E);) // LD C,E
+OPCODE(0x4C, ops.Load8<4>(C, H);) // LD C,H
+OPCODE(0x4D, ops.Load8<4>(C, L);) // LD C,L
+OPCODE(0x4E, ops.Load8<8>(C, gb.memory.ReadByte(HL));) // LD C,(HL)
+OPCODE(0x4F, ops.Load8<4>(C, A);) // LD C,A
+OPCODE(0x50, ops.Load8<4>(D, B);) // LD D,B
+OPCODE(0x51, ops.Load8<4>(D, C);) // LD D,C
+OPCODE(0x52, ops.Load8<4>(D, D);) // LD D,D
+OPCODE(0x53, ops.Load8<4>(D, E);) // LD D,E
+OPCODE(0x54, ops.Load8<4>(D, H);) // LD D,H
+OPCODE(0x55, ops.Load8<4>(D, L);) // LD D,L
+OPCODE(0x56, ops.Load8<8>(D, gb.memory.ReadByte(HL));) // LD D,(HL)
+OPCODE(0x57, ops.Load8<4>(D, A);) // LD D,A
+OPCODE(0x58, ops.Load8<4>(E, B);) // LD E,B
+OPCODE(0x59, ops.Load8<4>(E, C);) // LD E,C
+OPCODE(0x5A, ops.Load8<4>(E, D);) // LD E,D
+OPCODE(0x5B, ops.Load8<4>(E, E);) // LD E,E
+OPCODE(0x5C, ops.Load8<4>(E, H);) // LD E,H
+OPCODE(0x5D, ops.Load8<4>(E, L);) // LD E,L
+OPCODE(0x5E, ops.Load8<8>(E, gb.memory.ReadByte(HL));) // LD E,(HL)
+OPCODE(0x5F, ops.Load8<4>(E, A);) // LD E,A
+OPCODE(0x60, ops.Load8<4>(H, B);) // LD H,B
+OPCODE(0x61, ops.Load8<4>(H, C);) // LD H,C
+OPCODE(0x62, ops.Load8<4>(H, D);) // LD H,D
+OPCODE(0x63, ops.Load8<4>(H, E);) // LD H,E
+OPCODE(0x64, ops.Load8<4>(H, H);) // LD H,H
+OPCODE(0x65, ops.Load8<4>(H, L);) // LD H,L
+OPCODE(0x66, ops.Load8<8>(H, gb.memory.ReadByte(HL));) // LD H,(HL)
+OPCODE(0x67, ops.Load8<4>(H, A);) // LD H,A
+OPCODE(0x68, ops.Load8<4>(L, B);) // LD L,B
+OPCODE(0x69, ops.Load8<4>(L, C);) // LD L,C
+OPCODE(0x6A, ops.Load8<4>(L, D);) // LD L,D
+OPCODE(0x6B, ops.Load8<4>(L, E);) // LD L,E
+OPCODE(0x6C, ops.Load8<4>(L, H);) // LD L,H
+OPCODE(0x6D, ops.Load8<4>(L, L);) // LD L,L
+OPCODE(0x6E, ops.Load8<8>(L, gb.memory.ReadByte(HL));) // LD L,(HL)
+OPCODE(0x6F, ops.Load8<4>(L, A);) // LD L,A
+OPCODE(0x70, ops.Write8<8>(HL, B);) // LD (HL),B
+OPCODE(0x71, ops.Write8<8>(HL, C);) // LD (HL),C
+OPCODE(0x72, ops.Write8<8>(HL, D);) // LD (HL),D
+OPCODE(0x73, ops.Write8<8>(HL, E);) // LD (HL),E
+OPCODE(0x74, ops.Write8<8>(HL, H);) // LD (HL),H
+OPCODE(0x75, ops.Write8<8>(HL, L);) // LD (HL),L
+OPCODE(0x76, ops.Halt<4>();) // HALT
+OPCODE(0x77, ops.Write8<8>(HL, A);) // LD (HL),A
+OPCODE(0x78, ops.Load8<4>(A, B);) // LD A,B
+OPCODE(0x79, ops.Load8<4>(A, C);) // LD A,C
+OPCODE(0x7A, ops.Load8<4>(A, D);) // LD A,D
+OPCODE(0x7B, ops.Load8<4>(A, E);) // LD A,E
+OPCODE(0x7C, ops.Load8<4>(A, H);) // LD A,H
+OPCODE(0x7D, ops.Load8<4>(A, L);) // LD A,L
+OPCODE(0x7E, ops.Load8<8>(A, gb.memory.ReadByte(HL));) // LD A,(HL)
+OPCODE(0x7F, ops.Load8<4>(A, A);) // LD A,A
+OPCODE(0x80, ops.Add8<4>(A, B);) // ADD A,B
+OPCODE(0x81, ops.Add8<4>(A, C);) // ADD A,C
+OPCODE(0x82, ops.Add8<4>(A, D);) // ADD A,D
+OPCODE(0x83, ops.Add8<4>(A, E);) // ADD A,E
+OPCODE(0x84, ops.Add8<4>(A, H);) // ADD A,H
+OPCODE(0x85, ops.Add8<4>(A, L);) // ADD A,L
+OPCODE(0x86, ops.Add8<8>(A, gb.memory.ReadByte(HL));) // ADD A,(HL)
+OPCODE(0x87, ops.Add8<4>(A, A);) // ADD A,A
+OPCODE(0x88, ops.Adc8<4>(A, B);) // ADC A,B
+OPCODE(0x89, ops.Adc8<4>(A, C);) // ADC A,C
+OPCODE(0x8A, ops.Adc8<4>(A, D);) // ADC A,D
+OPCODE(0x8B, ops.Adc8<4>(A, E);) // ADC A,E
+OPCODE(0x8C, ops.Adc8<4>(A, H);) // ADC A,H
+OPCODE(0x8D, ops.Adc8<4>(A, L);) // ADC A,L
+OPCODE(0x8E, ops.Adc8<8>(A, gb.memory.ReadByte(HL));) // ADC A,(HL)
+OPCODE(0x8F, ops.Adc8<4>(A, A);) // ADC A,A
+OPCODE(0x90, ops.Sub8<4>(A, B);) // SUB A,B
+OPCODE(0x91, ops.Sub8<4>(A, C);) // SUB A,C
+OPCODE(0x92, ops.Sub8<4>(A, D);) // SUB A,D
+OPCODE(0x93, ops.Sub8<4>(A, E);) // SUB A,E
+OPCODE(0x94, ops.Sub8<4>(A, H);) // SUB A,H
+OPCODE(0x95, ops.Sub8<4>(A, L);) // SUB A,L
+OPCODE(0x96, ops.Sub8<8>(A, gb.memory.ReadByte(HL));) // SUB A,(HL)
+OPCODE(0x97, ops.Sub8<4>(A, A);) // SUB A,A
+OPCODE(0x98, ops.Sbc8<4>(A, B);) // SBC A,B
+OPCODE(0x99, ops.Sbc8<4>(A, C);) // SBC A,C
+OPCODE(0x9A, ops.Sbc8<4>(A, D);) // SBC A,D
+OPCODE(0x9B, ops.Sbc8<4>(A, E);) // SBC A,E
+OPCODE(0x9C, ops.Sbc8<4>(A, H);) // SBC A,H
+OPCODE(0x9D, ops.Sbc8<4>(A, L);) // SBC A,L
+OPCODE(0x9E, ops.Sbc8<8>(A, gb.memory.ReadByte(HL));) // SBC A,(HL)
+OPCODE(0x9F, ops.Sbc8<4>(A, A);) // SBC A,A
+OPCODE(0xA0, ops.And8<4>(A, B);) // AND A,B
+OPCODE(0xA1, ops.And8<4>(A, C);) // AND A,C
+OPCODE(0xA2, ops.And8<4>(A, D);) // AND A,D
+OPCODE(0xA3, ops.And8<4>(A, E);) // AND A,E
+OPCODE(0xA4, ops.And8<4>(A, H);) // AND A,H
+OPCODE(0xA5, ops.And8<4>(A, L);) // AND A,L
+OPCODE(0xA6, ops.And8<8>(A, gb.memory.ReadByte(HL));) // AND A,(HL)
+OPCODE(0xA7, ops.And8<4>(A, A);) // AND A,A
+OPCODE(0xA8, ops.Xor8<4>(A, B);) // XOR A,B
+OPCODE(0xA9, ops.Xor8<4>(A, C);) // XOR A,C
+OPCODE(0xAA, ops.Xor8<4>(A, D);) // XOR A,D
+OPCODE(0xAB, ops.Xor8<4>(A, E);) // XOR A,E
+OPCODE(0xAC, ops.Xor8<4>(A, H);) // XOR A,H
+OPCODE(0xAD, ops.Xor8<4>(A, L);) // XOR A,L
+OPCODE(0xAE, ops.Xor8<8>(A, gb.memory.ReadByte(HL));) // XOR A,(HL)
+OPCODE(0xAF, ops.Xor8<4>(A, A);) // XOR A,A
+OPCODE(0xB0, ops.Or8<4>(A, B);) // OR A,B
+OPCODE(0xB1, ops.Or8<4>(A, C);) // OR A,C
+OPCODE(0xB2, ops.Or8<4>(A, D);) // OR A,D
+OPCODE(0xB3, ops.Or8<4>(A, E);) // OR A,E
+OPCODE(0xB4, ops.Or8<4>(A, H);) // OR A,H
+OPCODE(0xB5, ops.Or8<4>(A, L);) // OR A,L
+OPCODE(0xB6, ops.Or8<8>(A, gb.memory.ReadByte(HL));) // OR A,(HL)
+OPCODE(0xB7, ops.Or8<4>(A, A);) // OR A,A
+OPCODE(0xB8, ops.Cmp8<4>(A, B);) // CP A,B
+OPCODE(0xB9, ops.Cmp8<4>(A, C);) // CP A,C
+OPCODE(0xBA, ops.Cmp8<4>(A, D);) // CP A,D
+OPCODE(0xBB, ops.Cmp8<4>(A, E);) // CP A,E
+OPCODE(0xBC, ops.Cmp8<4>(A, H);) // CP A,H
+OPCODE(0xBD, ops.Cmp8<4>(A, L);) // CP A,L
+OPCODE(0xBE, ops.Cmp8<8>(A, gb.memory.ReadByte(HL));) // CP A,(HL)
+OPCODE(0xBF, ops.Cmp8<4>(A, A);) // CP A,A
+OPCODE(0xC0, ops.Ret<8>(!flags.Get(Flags::z));) // RET NZ
+OPCODE(0xC1, BC = gb.memory.Pop(); cycles += 12;) // POP BC
+OPCODE(0xC2, ops.JmpImm<12>(!flags.Get(Flags::z), IMM16);) // JP NZ,a16
+OPCODE(0xC3, ops.JmpImm<12>(true, IMM16);) // JP a16
+OPCODE(0xC4, ops.Call<12>(!flags.Get(Flags::z), IMM16);) // CALL NZ,a16
+OPCODE(0xC5, gb.memory.Push(bc); cycles += 16;) // PUSH BC
+OPCODE(0xC6, ops.Add8<8>(A, IMM8); PC += 1;) // ADD A,d8
+OPCODE(0xC7, ops.Rst<0x00, 16>();) // RST 00H
+OPCODE(0xC8, ops.Ret<8>(flags.Get(Flags::z));) // RET Z
+OPCODE(0xC9, ops.Ret<8>(true);) // RET
+OPCODE(0xCA, ops.JmpImm<12>(flags.Get(Flags::z), IMM16);) // JP Z,a16
+OPCODE(0xCB, ExecuteExtendedOpcode(); cycles += 4;) // PREFIX CB
+OPCODE(0xCC, ops.Call<12>(flags.Get(Flags::z), IMM16);) // CALL Z,a16
+OPCODE(0xCD, ops.Call<12>(true, IMM16);) // CALL a16
+OPCODE(0xCE, ops.Adc8<8>(A, IMM8); PC += 1;) // ADC A,d8
+OPCODE(0xCF, ops.Rst<0x08, 16>();) // RST 08H
+OPCODE(0xD0, ops.Ret<8>(!flags.Get(Flags::c));) // RET NC
+OPCODE(0xD1, DE = gb.memory.Pop(); cycles += 12;) // POP DE
+OPCODE(0xD2, ops.JmpImm<12>(!flags.Get(Flags::c), IMM16);) // JP NC,a16
+OPCODE(0xD3, UnimplementedOpcode(0xD3);) // (unused)
+OPCODE(0xD4, ops.Call<12>(!flags.Get(Flags::c), IMM16);) // CALL NC,a16
+OPCODE(0xD5, gb.memory.Push(de); cycles += 16;) // PUSH DE
+OPCODE(0xD6, ops.Sub8<8>(A, IMM8); PC += 1;) // SUB A, d8
+OPCODE(0xD7, ops.Rst<0x10, 16>();) // RST 10H
+OPCODE(0xD8, ops.Ret<8>(flags.Get(Flags::c));) // RET C
+OPCODE(0xD9, ops.Ret<8>(true); gb.interrupts.ime = true;) // RETI
+OPCODE(0xDA, ops.JmpImm<12>(flags.Get(Flags::c), IMM16);) // JP C,a16
+OPCODE(0xDB, UnimplementedOpcode(0xDB);) // (unused)
+OPCODE(0xDC, ops.Call<12>(flags.Get(Flags::c), IMM16);) // CALL C,a16
+OPCODE(0xDD, UnimplementedOpcode(0xDD);) // (unused)
+OPCODE(0xDE, ops.Sbc8<8>(A, IMM8); PC += 1;) // SBC A,d8
+OPCODE(0xDF, ops.Rst<0x18, 16>();) // RST 18H
+OPCODE(0xE0, ops.Write8<12>(0xFF00 | IMM8, A); PC += 1;) // LDH (a8),A
+OPCODE(0xE1, HL = gb.memory.Pop(); cycles += 12;) // POP HL
+OPCODE(0xE2, ops.Write8<8>(0xFF00 | C, A);) // LD (C),A
+OPCODE(0xE3, UnimplementedOpcode(0xE3);) // (unused)
+OPCODE(0xE4, UnimplementedOpcode(0xE4);) // (unused)
+OPCODE(0xE5, gb.memory.Push(hl); cycles += 16;) // PUSH HL
+OPCODE(0xE6, ops.And8<8>(A, IMM8); PC += 1;) // AND A, d8
+OPCODE(0xE7, ops.Rst<0x20, 16>();) // RST 20H
+OPCODE(0xE8, ops.AddSpR8<16>(IMM8); PC += 1;) // ADD SP,r8
+OPCODE(0xE9, PC = HL; cycles += 4;) // JP (HL)
+OPCODE(0xEA, ops.Write8<16>(IMM16, A); PC += 2;) // LD (a16),A
+OPCODE(0xEB, UnimplementedOpcode(0xEB);) // (unused)
+OPCODE(0xEC, UnimplementedOpcode(0xEC);) // (unused)
+OPCODE(0xED, UnimplementedOpcode(0xED);) // (unused)
+OPCODE(0xEE, ops.Xor8<8>(A, IMM8); PC += 1;) // XOR A, d8
+OPCODE(0xEF, ops.Rst<0x28, 16>();) // RST 28H
+OPCODE(0xF0, ops.Load8<12>(A, gb.memory.ReadByte(0xFF00 | IMM8)); PC += 1;) // LDH A,(a8)
+OPCODE(0xF1, flags.Discard(); AF = (gb.memory.Pop() & ~0xF); cycles += 12;) // POP AF
+OPCODE(0xF2, ops.Load8<8>(A, gb.memory.ReadByte(0xFF00 | C));) // LD A,(C)
+OPCODE(0xF3, ops.DI<4>();) // DI
+OPCODE(0xF4, UnimplementedOpcode(0xF4);) // (unused)
+OPCODE(0xF5, flags.Resolve(); gb.memory.Push(af); cycles += 16;) // PUSH AF
+OPCODE(0xF6, ops.Or8<8>(A, IMM8); PC += 1;) // OR A, d8
+OPCODE(0xF7, ops.Rst<0x30, 16>();) // RST 30H
+OPCODE(0xF8, ops.LoadHlSpR8<12>(IMM8); PC += 1;) // LD HL,SP+r8
+OPCODE(0xF9, ops.Load16<8>(SP, HL);) // LD SP,HL
+OPCODE(0xFA, ops.Load8<16>(A, gb.memory.ReadByte(IMM16)); PC += 2;) // LD A,(a16)
+OPCODE(0xFB, ops.EI<4>();) // EI
+OPCODE(0xFC, UnimplementedOpcode(0xFC);) // (unused)
+OPCODE(0xFD, UnimplementedOpcode(0xFD);) // (unused)
+OPCODE(0xFE, ops.Cmp8<8>(A, IMM8); PC += 1;) // CP A, d8
+OPCODE(0xFF, ops.Rst<0x38, 16>();) // RST 38H
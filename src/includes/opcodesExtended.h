@@ -0,0 +1,268 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// every prefix-CB opcode, in order, as OPCODE(opcode, body) entries
+// cpu.cpp defines OPCODE before including this list, once per dispatch backend (so there is no include guard)
+
+OPCODE(0x00, ops.Rlc8<true, 8>(B);) // RLC B
+OPCODE(0x01, ops.Rlc8<true, 8>(C);) // RLC C
+OPCODE(0x02, ops.Rlc8<true, 8>(D);) // RLC D
+OPCODE(0x03, ops.Rlc8<true, 8>(E);) // RLC E
+OPCODE(0x04, ops.Rlc8<true, 8>(H);) // RLC H
+OPCODE(0x05, ops.Rlc8<true, 8>(L);) // RLC L
+OPCODE(0x06, ops.Rlc8Mem<true, 16>(HL);) // RLC (HL)
+OPCODE(0x07, ops.Rlc8<true, 8>(A);) // RLC A
+OPCODE(0x08, ops.Rrc8<true, 8>(B);) // RRC B
+OPCODE(0x09, ops.Rrc8<true, 8>(C);) // RRC C
+OPCODE(0x0A, ops.Rrc8<true, 8>(D);) // RRC D
+OPCODE(0x0B, ops.Rrc8<true, 8>(E);) // RRC E
+OPCODE(0x0C, ops.Rrc8<true, 8>(H);) // RRC H
+OPCODE(0x0D, ops.Rrc8<true, 8>(L);) // RRC L
+OPCODE(0x0E, ops.Rrc8Mem<true, 16>(HL);) // RRC (HL)
+OPCODE(0x0F, ops.Rrc8<true, 8>(A);) // RRC A
+OPCODE(0x10, ops.Rl8<true, 8>(B);) // RL B
+OPCODE(0x11, ops.Rl8<true, 8>(C);) // RL C
+OPCODE(0x12, ops.Rl8<true, 8>(D);) // RL D
+OPCODE(0x13, ops.Rl8<true, 8>(E);) // RL E
+OPCODE(0x14, ops.Rl8<true, 8>(H);) // RL H
+OPCODE(0x15, ops.Rl8<true, 8>(L);) // RL L
+OPCODE(0x16, ops.Rl8Mem<true, 16>(HL);) // RL (HL)
+OPCODE(0x17, ops.Rl8<true, 8>(A);) // RL A
+OPCODE(0x18, ops.Rr8<true, 8>(B);) // RR B
+OPCODE(0x19, ops.Rr8<true, 8>(C);) // RR C
+OPCODE(0x1A, ops.Rr8<true, 8>(D);) // RR D
+OPCODE(0x1B, ops.Rr8<true, 8>(E);) // RR E
+OPCODE(0x1C, ops.Rr8<true, 8>(H);) // RR H
+OPCODE(0x1D, ops.Rr8<true, 8>(L);) // RR L
+OPCODE(0x1E, ops.Rr8Mem<true, 16>(HL);) // RR (HL)
+OPCODE(0x1F, ops.Rr8<true, 8>(A);) // RR A
+OPCODE(0x20, ops.Slc8<8>(B);) // SLA B
+OPCODE(0x21, ops.Slc8<8>(C);) // SLA C
+OPCODE(0x22, ops.Slc8<8>(D);) // SLA D
+OPCODE(0x23, ops.Slc8<8>(E);) // SLA E
+OPCODE(0x24, ops.Slc8<8>(H);) // SLA H
+OPCODE(0x25, ops.Slc8<8>(L);) // SLA L
+OPCODE(0x26, ops.Slc8Mem<16>(HL);) // SLA (HL)
+OPCODE(0x27, ops.Slc8<8>(A);) // SLA A
+OPCODE(0x28, ops.Sr8<8>(B);) // SRA B
+OPCODE(0x29, ops.Sr8<8>(C);) // SRA C
+OPCODE(0x2A, ops.Sr8<8>(D);) // SRA D
+OPCODE(0x2B, ops.Sr8<8>(E);) // SRA E
+OPCODE(0x2C, ops.Sr8<8>(H);) // SRA H
+OPCODE(0x2D, ops.Sr8<8>(L);) // SRA L
+OPCODE(0x2E, ops.Sr8Mem<16>(HL);) // SRA (HL)
+OPCODE(0x2F, ops.Sr8<8>(A);) // SRA A
+OPCODE(0x30, ops.BitSwap<8>(B);) // SWAP B
+OPCODE(0x31, ops.BitSwap<8>(C);) // SWAP C
+OPCODE(0x32, ops.BitSwap<8>(D);) // SWAP D
+OPCODE(0x33, ops.BitSwap<8>(E);) // SWAP E
+OPCODE(0x34, ops.BitSwap<8>(H);) // SWAP H
+OPCODE(0x35, ops.BitSwap<8>(L);) // SWAP L
+OPCODE(0x36, ops.BitSwapMem<16>(HL);) // SWAP (HL)
+OPCODE(0x37, ops.BitSwap<8>(A);) // SWAP A
+OPCODE(0x38, ops.Src8<8>(B);) // SRL B
+OPCODE(0x39, ops.Src8<8>(C);) // SRL C
+OPCODE(0x3A, ops.Src8<8>(D);) // SRL D
+OPCODE(0x3B, ops.Src8<8>(E);) // SRL E
+OPCODE(0x3C, ops.Src8<8>(H);) // SRL H
+OPCODE(0x3D, ops.Src8<8>(L);) // SRL L
+OPCODE(0x3E, ops.Src8Mem<16>(HL);) // SRL (HL)
+OPCODE(0x3F, ops.Src8<8>(A);) // SRL A
+OPCODE(0x40, ops.BitTest<0, 8>(B);) // BIT 0,B
+OPCODE(0x41, ops.BitTest<0, 8>(C);) // BIT 0,C
+OPCODE(0x42, ops.BitTest<0, 8>(D);) // BIT 0,D
+OPCODE(0x43, ops.BitTest<0, 8>(E);) // BIT 0,E
+OPCODE(0x44, ops.BitTest<0, 8>(H);) // BIT 0,H
+OPCODE(0x45, ops.BitTest<0, 8>(L);) // BIT 0,L
+OPCODE(0x46, ops.BitTestMem<0, 16>(HL);) // BIT 0,(HL)
+OPCODE(0x47, ops.BitTest<0, 8>(A);) // BIT 0,A
+OPCODE(0x48, ops.BitTest<1, 8>(B);) // BIT 1,B
+OPCODE(0x49, ops.BitTest<1, 8>(C);) // BIT 1,C
+OPCODE(0x4A, ops.BitTest<1, 8>(D);) // BIT 1,D
+OPCODE(0x4B, ops.BitTest<1, 8>(E);) // BIT 1,E
+OPCODE(0x4C, ops.BitTest<1, 8>(H);) // BIT 1,H
+OPCODE(0x4D, ops.BitTest<1, 8>(L);) // BIT 1,L
+OPCODE(0x4E, ops.BitTestMem<1, 16>(HL);) // BIT 1,(HL)
+OPCODE(0x4F, ops.BitTest<1, 8>(A);) // BIT 1,A
+OPCODE(0x50, ops.BitTest<2, 8>(B);) // BIT 2,B
+OPCODE(0x51, ops.BitTest<2, 8>(C);) // BIT 2,C
+OPCODE(0x52, ops.BitTest<2, 8>(D);) // BIT 2,D
+OPCODE(0x53, ops.BitTest<2, 8>(E);) // BIT 2,E
+OPCODE(0x54, ops.BitTest<2, 8>(H);) // BIT 2,H
+OPCODE(0x55, ops.BitTest<2, 8>(L);) // BIT 2,L
+OPCODE(0x56, ops.BitTestMem<2, 16>(HL);) // BIT 2,(HL)
+OPCODE(0x57, ops.BitTest<2, 8>(A);) // BIT 2,A
+OPCODE(0x58, ops.BitTest<3, 8>(B);) // BIT 3,B
+OPCODE(0x59, ops.BitTest<3, 8>(C);) // BIT 3,C
+OPCODE(0x5A, ops.BitTest<3, 8>(D);) // BIT 3,D
+OPCODE(0x5B, ops.BitTest<3, 8>(E);) // BIT 3,E
+OPCODE(0x5C, ops.BitTest<3, 8>(H);) // BIT 3,H
+OPCODE(0x5D, ops.BitTest<3, 8>(L);) // BIT 3,L
+OPCODE(0x5E, ops.BitTestMem<3, 16>(HL);) // BIT 3,(HL)
+OPCODE(0x5F, ops.BitTest<3, 8>(A);) // BIT 3,A
+OPCODE(0x60, ops.BitTest<4, 8>(B);) // BIT 4,B
+OPCODE(0x61, ops.BitTest<4, 8>(C);) // BIT 4,C
+OPCODE(0x62, ops.BitTest<4, 8>(D);) // BIT 4,D
+OPCODE(0x63, ops.BitTest<4, 8>(E);) // BIT 4,E
+OPCODE(0x64, ops.BitTest<4, 8>(H);) // BIT 4,H
+OPCODE(0x65, ops.BitTest<4, 8>(L);) // BIT 4,L
+OPCODE(0x66, ops.BitTestMem<4, 16>(HL);) // BIT 4,(HL)
+OPCODE(0x67, ops.BitTest<4, 8>(A);) // BIT 4,A
+OPCODE(0x68, ops.BitTest<5, 8>(B);) // BIT 5,B
+OPCODE(0x69, ops.BitTest<5, 8>(C);) // BIT 5,C
+OPCODE(0x6A, ops.BitTest<5, 8>(D);) // BIT 5,D
+OPCODE(0x6B, ops.BitTest<5, 8>(E);) // BIT 5,E
+OPCODE(0x6C, ops.BitTest<5, 8>(H);) // BIT 5,H
+OPCODE(0x6D, ops.BitTest<5, 8>(L);) // BIT 5,L
+OPCODE(0x6E, ops.BitTestMem<5, 16>(HL);) // BIT 5,(HL)
+OPCODE(0x6F, ops.BitTest<5, 8>(A);) // BIT 5,A
+OPCODE(0x70, ops.BitTest<6, 8>(B);) // BIT 6,B
+OPCODE(0x71, ops.BitTest<6, 8>(C);) // BIT 6,C
+OPCODE(0x72, ops.BitTest<6, 8>(D);) // BIT 6,D
+OPCODE(0x73, ops.BitTest<6, 8>(E);) // BIT 6,E
+OPCODE(0x74, ops.BitTest<6, 8>(H);) // BIT 6,H
+OPCODE(0x75, ops.BitTest<6, 8>(L);) // BIT 6,L
+OPCODE(0x76, ops.BitTestMem<6, 16>(HL);) // BIT 6,(HL)
+OPCODE(0x77, ops.BitTest<6, 8>(A);) // BIT 6,A
+OPCODE(0x78, ops.BitTest<7, 8>(B);) // BIT 7,B
+OPCODE(0x79, ops.BitTest<7, 8>(C);) // BIT 7,C
+OPCODE(0x7A, ops.BitTest<7, 8>(D);) // BIT 7,D
+OPCODE(0x7B, ops.BitTest<7, 8>(E);) // BIT 7,E
+OPCODE(0x7C, ops.BitTest<7, 8>(H);) // BIT 7,H
+OPCODE(0x7D, ops.BitTest<7, 8>(L);) // BIT 7,L
+OPCODE(0x7E, ops.BitTestMem<7, 16>(HL);) // BIT 7,(HL)
+OPCODE(0x7F, ops.BitTest<7, 8>(A);) // BIT 7,A
+OPCODE(0x80, ops.BitClear<0, 8>(B);) // RES 0,B
+OPCODE(0x81, ops.BitClear<0, 8>(C);) // RES 0,C
+OPCODE(0x82, ops.BitClear<0, 8>(D);) // RES 0,D
+OPCODE(0x83, ops.BitClear<0, 8>(E);) // RES 0,E
+OPCODE(0x84, ops.BitClear<0, 8>(H);) // RES 0,H
+OPCODE(0x85, ops.BitClear<0, 8>(L);) // RES 0,L
+OPCODE(0x86, ops.BitClearMem<0, 16>(HL);) // RES 0,(HL)
+OPCODE(0x87, ops.BitClear<0, 8>(A);) // RES 0,A
+OPCODE(0x88, ops.BitClear<1, 8>(B);) // RES 1,B
+OPCODE(0x89, ops.BitClear<1, 8>(C);) // RES 1,C
+OPCODE(0x8A, ops.BitClear<1, 8>(D);) // RES 1,D
+OPCODE(0x8B, ops.BitClear<1, 8>(E);) // RES 1,E
+OPCODE(0x8C, ops.BitClear<1, 8>(H);) // RES 1,H
+OPCODE(0x8D, ops.BitClear<1, 8>(L);) // RES 1,L
+OPCODE(0x8E, ops.BitClearMem<1, 16>(HL);) // RES 1,(HL)
+OPCODE(0x8F, ops.BitClear<1, 8>(A);) // RES 1,A
+OPCODE(0x90, ops.BitClear<2, 8>(B);) // RES 2,B
+OPCODE(0x91, ops.BitClear<2, 8>(C);) // RES 2,C
+OPCODE(0x92, ops.BitClear<2, 8>(D);) // RES 2,D
+OPCODE(0x93, ops.BitClear<2, 8>(E);) // RES 2,E
+OPCODE(0x94, ops.BitClear<2, 8>(H);) // RES 2,H
+OPCODE(0x95, ops.BitClear<2, 8>(L);) // RES 2,L
+OPCODE(0x96, ops.BitClearMem<2, 16>(HL);) // RES 2,(HL)
+OPCODE(0x97, ops.BitClear<2, 8>(A);) // RES 2,A
+OPCODE(0x98, ops.BitClear<3, 8>(B);) // RES 3,B
+OPCODE(0x99, ops.BitClear<3, 8>(C);) // RES 3,C
+OPCODE(0x9A, ops.BitClear<3, 8>(D);) // RES 3,D
+OPCODE(0x9B, ops.BitClear<3, 8>(E);) // RES 3,E
+OPCODE(0x9C, ops.BitClear<3, 8>(H);) // RES 3,H
+OPCODE(0x9D, ops.BitClear<3, 8>(L);) // RES 3,L
+OPCODE(0x9E, ops.BitClearMem<3, 16>(HL);) // RES 3,(HL)
+OPCODE(0x9F, ops.BitClear<3, 8>(A);) // RES 3,A
+OPCODE(0xA0, ops.BitClear<4, 8>(B);) // RES 4,B
+OPCODE(0xA1, ops.BitClear<4, 8>(C);) // RES 4,C
+OPCODE(0xA2, ops.BitClear<4, 8>(D);) // RES 4,D
+OPCODE(0xA3, ops.BitClear<4, 8>(E);) // RES 4,E
+OPCODE(0xA4, ops.BitClear<4, 8>(H);) // RES 4,H
+OPCODE(0xA5, ops.BitClear<4, 8>(L);) // RES 4,L
+OPCODE(0xA6, ops.BitClearMem<4, 16>(HL);) // RES 4,(HL)
+OPCODE(0xA7, ops.BitClear<4, 8>(A);) // RES 4,A
+OPCODE(0xA8, ops.BitClear<5, 8>(B);) // RES 5,B
+OPCODE(0xA9, ops.BitClear<5, 8>(C);) // RES 5,C
+OPCODE(0xAA, ops.BitClear<5, 8>(D);) // RES 5,D
+OPCODE(0xAB, ops.BitClear<5, 8>(E);) // RES 5,E
+OPCODE(0xAC, ops.BitClear<5, 8>(H);) // RES 5,H
+OPCODE(0xAD, ops.BitClear<5, 8>(L);) // RES 5,L
+OPCODE(0xAE, ops.BitClearMem<5, 16>(HL);) // RES 5,(HL)
+OPCODE(0xAF, ops.BitClear<5, 8>(A);) // RES 5,A
+OPCODE(0xB0, ops.BitClear<6, 8>(B);) // RES 6,B
+OPCODE(0xB1, ops.BitClear<6, 8>(C);) // RES 6,C
+OPCODE(0xB2, ops.BitClear<6, 8>(D);) // RES 6,D
+OPCODE(0xB3, ops.BitClear<6, 8>(E);) // RES 6,E
+OPCODE(0xB4, ops.BitClear<6, 8>(H);) // RES 6,H
+OPCODE(0xB5, ops.BitClear<6, 8>(L);) // RES 6,L
+OPCODE(0xB6, ops.BitClearMem<6, 16>(HL);) // RES 6,(HL)
+OPCODE(0xB7, ops.BitClear<6, 8>(A);) // RES 6,A
+OPCODE(0xB8, ops.BitClear<7, 8>(B);) // RES 7,B
+OPCODE(0xB9, ops.BitClear<7, 8>(C);) // RES 7,C
+OPCODE(0xBA, ops.BitClear<7, 8>(D);) // RES 7,D
+OPCODE(0xBB, ops.BitClear<7, 8>(E);) // RES 7,E
+OPCODE(0xBC, ops.BitClear<7, 8>(H);) // RES 7,H
+OPCODE(0xBD, ops.BitClear<7, 8>(L);) // RES 7,L
+OPCODE(0xBE, ops.BitClearMem<7, 16>(HL);) // RES 7,(HL)
+OPCODE(0xBF, ops.BitClear<7, 8>(A);) // RES 7,A
+OPCODE(0xC0, ops.BitSet<0, 8>(B);) // SET 0,B
+OPCODE(0xC1, ops.BitSet<0, 8>(C);) // SET 0,C
+OPCODE(0xC2, ops.BitSet<0, 8>(D);) // SET 0,D
+OPCODE(0xC3, ops.BitSet<0, 8>(E);) // SET 0,E
+OPCODE(0xC4, ops.BitSet<0, 8>(H);) // SET 0,H
+OPCODE(0xC5, ops.BitSet<0, 8>(L);) // SET 0,L
+OPCODE(0xC6, ops.BitSetMem<0, 16>(HL);) // SET 0,(HL)
+OPCODE(0xC7, ops.BitSet<0, 8>(A);) // SET 0,A
+OPCODE(0xC8, ops.BitSet<1, 8>(B);) // SET 1,B
+OPCODE(0xC9, ops.BitSet<1, 8>(C);) // SET 1,C
+OPCODE(0xCA, ops.BitSet<1, 8>(D);) // SET 1,D
+OPCODE(0xCB, ops.BitSet<1, 8>(E);) // SET 1,E
+OPCODE(0xCC, ops.BitSet<1, 8>(H);) // SET 1,H
+OPCODE(0xCD, ops.BitSet<1, 8>(L);) // SET 1,L
+OPCODE(0xCE, ops.BitSetMem<1, 16>(HL);) // SET 1,(HL)
+OPCODE(0xCF, ops.BitSet<1, 8>(A);) // SET 1,A
+OPCODE(0xD0, ops.BitSet<2, 8>(B);) // SET 2,B
+OPCODE(0xD1, ops.BitSet<2, 8>(C);) // SET 2,C
+OPCODE(0xD2, ops.BitSet<2, 8>(D);) // SET 2,D
+OPCODE(0xD3, ops.BitSet<2, 8>(E);) // SET 2,E
+OPCODE(0xD4, ops.BitSet<2, 8>(H);) // SET 2,H
+OPCODE(0xD5, ops.BitSet<2, 8>(L);) // SET 2,L
+OPCODE(0xD6, ops.BitSetMem<2, 16>(HL);) // SET 2,(HL)
+OPCODE(0xD7, ops.BitSet<2, 8>(A);) // SET 2,A
+OPCODE(0xD8, ops.BitSet<3, 8>(B);) // SET 3,B
+OPCODE(0xD9, ops.BitSet<3, 8>(C);) // SET 3,C
+OPCODE(0xDA, ops.BitSet<3, 8>(D);) // SET 3,D
+OPCODE(0xDB, ops.BitSet<3, 8>(E);) // SET 3,E
+OPCODE(0xDC, ops.BitSet<3, 8>(H);) // SET 3,H
+OPCODE(0xDD, ops.BitSet<3, 8>(L);) // SET 3,L
+OPCODE(0xDE, ops.BitSetMem<3, 16>(HL);) // SET 3,(HL)
+OPCODE(0xDF, ops.BitSet<3, 8>(A);) // SET 3,A
+OPCODE(0xE0, ops.BitSet<4, 8>(B);) // SET 4,B
+OPCODE(0xE1, ops.BitSet<4, 8>(C);) // SET 4,C
+OPCODE(0xE2, ops.BitSet<4, 8>(D);) // SET 4,D
+OPCODE(0xE3, ops.BitSet<4, 8>(E);) // SET 4,E
+OPCODE(0xE4, ops.BitSet<4, 8>(H);) // SET 4,H
+OPCODE(0xE5, ops.BitSet<4, 8>(L);) // SET 4,L
+OPCODE(0xE6, ops.BitSetMem<4, 16>(HL);) // SET 4,(HL)
+OPCODE(0xE7, ops.BitSet<4, 8>(A);) // SET 4,A
+OPCODE(0xE8, ops.BitSet<5, 8>(B);) // SET 5,B
+OPCODE(0xE9, ops.BitSet<5, 8>(C);) // SET 5,C
+OPCODE(0xEA, ops.BitSet<5, 8>(D);) // SET 5,D
+OPCODE(0xEB, ops.BitSet<5, 8>(E);) // SET 5,E
+OPCODE(0xEC, ops.BitSet<5, 8>(H);) // SET 5,H
+OPCODE(0xED, ops.BitSet<5, 8>(L);) // SET 5,L
+OPCODE(0xEE, ops.BitSetMem<5, 16>(HL);) // SET 5,(HL)
+OPCODE(0xEF, ops.BitSet<5, 8>(A);) // SET 5,A
+OPCODE(0xF0, ops.BitSet<6, 8>(B);) // SET 6,B
+OPCODE(0xF1, ops.BitSet<6, 8>(C);) // SET 6,C
+OPCODE(0xF2, ops.BitSet<6, 8>(D);) // SET 6,D
+OPCODE(0xF3, ops.BitSet<6, 8>(E);) // SET 6,E
+OPCODE(0xF4, ops.BitSet<6, 8>(H);) // SET 6,H
+OPCODE(0xF5, ops.BitSet<6, 8>(L);) // SET 6,L
+OPCODE(0xF6, ops.BitSetMem<6, 16>(HL);) // SET 6,(HL)
+OPCODE(0xF7, ops.BitSet<6, 8>(A);) // SET 6,A
+OPCODE(0xF8, ops.BitSet<7, 8>(B);) // SET 7,B
+OPCODE(0xF9, ops.BitSet<7, 8>(C);) // SET 7,C
+OPCODE(0xFA, ops.BitSet<7, 8>(D);) // SET 7,D
+OPCODE(0xFB, ops.BitSet<7, 8>(E);) // SET 7,E
+OPCODE(0xFC, ops.BitSet<7, 8>(H);) // SET 7,H
+OPCODE(0xFD, ops.BitSet<7, 8>(L);) // SET 7,L
+OPCODE(0xFE, ops.BitSetMem<7, 16>(HL);) // SET 7,(HL)
+OPCODE(0xFF, ops.BitSet<7, 8>(A);) // SET 7,A
@@ -0,0 +1,17 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// every pair of opcodes the block cache fuses into one handler, as FUSED(id, first, second) entries (ids start at 1, 0 = not fused)
+// cpu.cpp and blockCache.cpp define FUSED before including this list (so there is no include guard)
+// the first opcode of a pair can't jump, write memory or take a variable amount of cycles
+
+FUSED(1, 0x2A, 0x12) // LD A,(HL+) + LD (DE),A (copy loops)
+FUSED(2, 0x05, 0x20) // DEC B + JR NZ,r8 (counted loops)
+FUSED(3, 0xF0, 0xFE) // LDH A,(a8) + CP A,d8 (polling an io register)
+FUSED(4, 0xAF, 0x77) // XOR A + LD (HL),A (clearing memory)
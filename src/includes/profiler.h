@@ -0,0 +1,70 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// includes
+#include "typedefs.h"
+
+// definitions
+// marks the rest of the enclosing scope as time spent in a section (compiled out unless PROFILE_SECTIONS is defined)
+#ifdef PROFILE_SECTIONS
+#define PROFILE_SECTION(section) Profiler::Scope profilerScope(section)
+#else
+#define PROFILE_SECTION(section)
+#endif
+
+// samples which section the emulator is in from a timer signal, so the hot paths only pay for a store on the way in/out
+class Profiler
+{
+	public:
+		enum Section
+		{
+			OTHER, CPU, MEMORY, LCD, LCD_DRAW, TIMER, SECTION_COUNT,
+		};
+
+		// responsible for marking a section for as long as it is in scope
+		class Scope
+		{
+			public:
+				Scope(int section) : previous(current)
+				{
+					current = section;
+				}
+
+				~Scope()
+				{
+					current = previous;
+				}
+
+			private:
+				int previous;
+		};
+
+	public:
+		static bool Available();
+		static bool Start();
+		static void Stop();
+		static void Reset();
+		static long long Samples(int section);
+		static long long TotalSamples();
+		static const char *Name(int section);
+
+	private:
+		static void OnSample(int signal);
+
+	public:
+		static volatile int current;
+
+	private:
+		static volatile long long samples[SECTION_COUNT];
+};
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef REWIND_H
+#define REWIND_H
+
+// includes
+#include <cstdio>
+#include <deque>
+#include <vector>
+#include "stats.h"
+#include "typedefs.h"
+
+class GameBoy;
+
+// keeps a snapshot every few frames in a fixed size ring, each stored as an xor + rle delta against the newer one
+class Rewind
+{
+	public:
+		Rewind(GameBoy &gb);
+		void Enable(size_t bufferSize, int interval);
+		void Disable();
+		void Clear();
+		void Capture();
+		void OnFrame();
+		bool StepBack();
+		bool StepBackInstruction();
+		bool RewindTo(long long cycles);
+		bool HasSnapshot();
+		size_t Count();
+		size_t BytesUsed();
+
+	private:
+		struct Delta
+		{
+			size_t offset;
+			size_t length;
+			// the cpu's total cycles when the older snapshot was taken
+			long long cycles;
+		};
+
+		// what a replay turns off and puts back afterwards, so steps that run again aren't seen twice
+		struct Replay
+		{
+			bool idleLoops;
+			bool fuseOps;
+			FILE *serialOutput;
+		};
+
+		bool Seek(long long cycles);
+		void BeginReplay(Replay &replay);
+		void EndReplay(const Replay &replay);
+		void Push(long long cycles);
+		void Pop();
+		void Evict(size_t start, size_t end);
+		size_t Encode(const u8 *older, const u8 *newer, size_t size, u8 *out);
+		void Decode(const u8 *delta, size_t length, u8 *snapshot);
+
+	public:
+		bool enabled;
+		// how many frames go by between snapshots
+		int interval;
+
+	private:
+		GameBoy &gb;
+		// the newest snapshot, kept whole so older ones can be rebuilt from it
+		std::vector<u8> latest;
+		long long latestCycles;
+		std::vector<u8> scratch;
+		std::vector<u8> encoded;
+		// the deltas live back to back in the ring, oldest first
+		std::vector<u8> ring;
+		std::deque<Delta> deltas;
+		size_t ringHead;
+		int framesSinceCapture;
+		// the counters as they were before a replay (only used in builds with COLLECT_STATS)
+		Stats replayStats;
+};
+
+#endif
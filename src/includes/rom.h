@@ -13,28 +13,37 @@
 // includes
 #include "typedefs.h"
 
+class GameBoy;
+class StateBuffer;
+
 class Rom
 {
 	public:
-		static bool Load(const char *filePath);
-		static bool Select();
-		static void Reload();
-		static bool HasLoaded();
-		static bool LoadRam(int num = 0);
-		static void SaveRam(int num = 0);
+		Rom(GameBoy &gb);
+		~Rom();
+		bool Load(const char *filePath);
+		void Reload();
+		bool HasLoaded();
+		bool LoadRam(int num = 0);
+		void SaveRam(int num = 0);
+		void Serialize(StateBuffer &state);
 
 	public:
-		static u8 rom[0x4000 * 512];
-		static u8 ram[0x2000 * 16];
-		static u8 mbcType;
-		static u8 romSize;
-		static u8 ramSize;
-		static u16 romBank;
-		static u8 ramBank;
-		static u8 currentMode;
-		static bool hasBatteryBackup;
-		static const char *filename;
-		static char romName[256];
+		u8 *rom;
+		u8 ram[0x2000 * 16];
+		u8 mbcType;
+		u8 romSize;
+		u8 ramSize;
+		u16 romBank;
+		u16 romBankMask;
+		u8 ramBank;
+		u8 currentMode;
+		bool hasBatteryBackup;
+		const char *filename;
+		char romName[256];
+
+	private:
+		GameBoy &gb;
 };
 
 #endif
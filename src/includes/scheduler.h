@@ -0,0 +1,37 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+// includes
+#include "typedefs.h"
+
+class GameBoy;
+
+// lets the cpu run until the timer or lcd next has something to do (a DIV tick, TIMA overflow, STAT mode change or new line)
+class Scheduler
+{
+	public:
+		Scheduler(GameBoy &gb);
+		void Init();
+		void Run(int cycles);
+		void Sync();
+
+	public:
+		int elapsed;
+		int nextEvent;
+
+	private:
+		GameBoy &gb;
+		int timerEvent;
+		int lcdEvent;
+};
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+// includes
+#include <atomic>
+
+// a lock-free queue with exactly one producer thread and one consumer thread (size must be a power of two)
+template <typename T, int SIZE>
+class SpscQueue
+{
+	public:
+		SpscQueue() : head(0), tail(0)
+		{
+
+		}
+
+		// responsible for adding an item (returns false if the queue is full)
+		bool Push(const T &item)
+		{
+			const unsigned int writeIndex = tail.load(std::memory_order_relaxed);
+
+			if ((writeIndex - head.load(std::memory_order_acquire)) >= SIZE) return false;
+
+			items[writeIndex & (SIZE - 1)] = item;
+			tail.store(writeIndex + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		// responsible for removing the oldest item (returns false if the queue is empty)
+		bool Pop(T &item)
+		{
+			const unsigned int readIndex = head.load(std::memory_order_relaxed);
+
+			if (readIndex == tail.load(std::memory_order_acquire)) return false;
+
+			item = items[readIndex & (SIZE - 1)];
+			head.store(readIndex + 1, std::memory_order_release);
+
+			return true;
+		}
+
+	private:
+		T items[SIZE];
+		std::atomic<unsigned int> head;
+		std::atomic<unsigned int> tail;
+};
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef STATE_BUFFER_H
+#define STATE_BUFFER_H
+
+// includes
+#include "typedefs.h"
+
+// reads or writes machine state from/to a flat buffer, so each component has one Serialize function for both directions
+class StateBuffer
+{
+	public:
+		StateBuffer(u8 *data, size_t size);
+		StateBuffer(const u8 *data, size_t size);
+		void Bytes(void *value, size_t length);
+		size_t Offset();
+		bool Failed();
+
+		// responsible for reading/writing a single value
+		template <typename T> void Value(T &value)
+		{
+			Bytes(&value, sizeof(T));
+		}
+
+	public:
+		// true when the buffer is being read back into the machine
+		const bool loading;
+
+	private:
+		// NULL when only measuring how big a state is
+		u8 *data;
+		size_t size;
+		size_t offset;
+		bool failed;
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+// includes
+#include "typedefs.h"
+
+// definitions
+// runs the statement only in builds with COLLECT_STATS defined, so the counters cost nothing otherwise
+#ifdef COLLECT_STATS
+#define STATS(statement) statement
+#else
+#define STATS(statement)
+#endif
+#define STATS_INTERRUPT_COUNT 5
+
+class GameBoy;
+
+// counts what the machine spends its time on (opcodes, memory regions, bank switches and interrupts)
+class Stats
+{
+	public:
+		enum Region
+		{
+			ROM0, ROMX, VRAM, ERAM, WRAM, OAM, IO, HRAM, REGION_COUNT,
+		};
+
+	public:
+		Stats(GameBoy &gb);
+		static bool Available();
+		void Reset();
+		void CopyCounters(const Stats &other);
+		void CountBanking(u16 romBank, u8 ramBank);
+		bool DumpCsv(const char *filePath);
+		static const char *RegionName(int region);
+		static const char *InterruptName(int id);
+
+		// responsible for counting an opcode and the cycles it took (the cb prefix is counted under the opcode it prefixes)
+		void CountOpcode(u8 opcode, u8 operand, int cycles)
+		{
+			if (opcode == 0xCB)
+			{
+				extendedCount[operand] += 1;
+				extendedCycles[operand] += cycles;
+			}
+			else
+			{
+				opcodeCount[opcode] += 1;
+				opcodeCycles[opcode] += cycles;
+			}
+		}
+
+		// responsible for counting a read from memory
+		void CountRead(u16 address)
+		{
+			reads[GetRegion(address)] += 1;
+		}
+
+		// responsible for counting a write to memory
+		void CountWrite(u16 address)
+		{
+			writes[GetRegion(address)] += 1;
+		}
+
+		// responsible for returning which region of the memory map an address is in
+		static Region GetRegion(u16 address)
+		{
+			if (address < 0x4000) return ROM0;
+			if (address < 0x8000) return ROMX;
+			if (address < 0xA000) return VRAM;
+			if (address < 0xC000) return ERAM;
+			// echo ram counts as work ram
+			if (address < 0xFE00) return WRAM;
+			if (address < 0xFF00) return OAM;
+			if (address < 0xFF80 || address == 0xFFFF) return IO;
+
+			return HRAM;
+		}
+
+	public:
+		long long opcodeCount[0x100];
+		long long opcodeCycles[0x100];
+		long long extendedCount[0x100];
+		long long extendedCycles[0x100];
+		long long haltedCycles;
+		long long idleLoopCycles;
+		long long reads[REGION_COUNT];
+		long long writes[REGION_COUNT];
+		long long romBankSwitches;
+		long long ramBankSwitches;
+		long long interrupts[STATS_INTERRUPT_COUNT];
+
+	private:
+		GameBoy &gb;
+};
+
+#endif
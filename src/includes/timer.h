@@ -7,21 +7,37 @@
  * Copyright 2017 - Danny Glover. All rights reserved.
  */
 
+#ifndef TIMER_H
+#define TIMER_H
+
 // includes
 #include "typedefs.h"
 
+class GameBoy;
+class StateBuffer;
+
 class Timer
 {
 	public:
-		static void Init();
-		static u16 GetFrequency();
-		static bool Enabled();
-		static void Update(int cycles);
+		Timer(GameBoy &gb);
+		void Init();
+		u16 GetFrequency();
+		bool Enabled();
+		void Update(int cycles);
+		void Advance(int cycles);
+		int NextEvent();
+		void Serialize(StateBuffer &state);
 
 	public:
-		static int timerCounter;
-		static int divCounter;
+		int timerCounter;
+		int divCounter;
 
 	private:
-		static void UpdateDiv(int cycles);
+		void UpdateDiv(int cycles);
+
+	private:
+		bool counting;
+		GameBoy &gb;
 };
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+// includes
+#include <atomic>
+#include "typedefs.h"
+
+// definitions
+#define TRIPLE_BUFFER_SIZE (160 * 144 * 3)
+
+// hands finished rgb frames from the emulation thread to the render thread without locking
+class TripleBuffer
+{
+	public:
+		TripleBuffer();
+		u8 *GetBackBuffer();
+		void Publish();
+		const u8 *Acquire();
+
+	private:
+		u8 buffers[3][TRIPLE_BUFFER_SIZE];
+		// the buffer the producer is writing
+		int back;
+		// the buffer the consumer is reading
+		int front;
+		// the buffer in between, flagged as fresh while it holds an unread frame
+		std::atomic<int> middle;
+};
+
+#endif
@@ -13,19 +13,30 @@
 // includes
 #include "typedefs.h"
 
+class GameBoy;
+
 class Ui
 {
 	public:
+		static void Init(GameBoy *gameBoy);
 		static void Render();
 		static void SetStatusMessage(const char *title, const char *message);
 		static void HideStatusWindow();
 		static void ShowStatusWindow();
 		static void HideMainMenuBar();
 		static void ShowMainMenuBar();
+		static bool SelectRom(bool reset = false);
+		static void SaveState();
+		static void LoadState();
+		static void RecordMovie();
+		static void PlayMovie();
+		static void StopMovie();
+		static void SetFps(double emulated, double host);
 
 	private:
 		static void StatusWindowOverlay();
 		static void AboutPopupWindow();
+		static void FpsOverlay();
 
 	public:
 		enum
@@ -34,6 +45,9 @@ class Ui
 			MemorySetValuePopup, ModifyRegistersPopup, SetBreakpointPopup,
 		};
 
+		static int speed;
+		static bool turbo;
+
 	private:
 		static char statusText[512];
 		static char statusTextTitle[256];
@@ -0,0 +1,65 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+// includes
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "typedefs.h"
+
+class GameBoy;
+
+// runs a queue of rom jobs on a pool of threads, one GameBoy per job
+class WorkerPool
+{
+	public:
+		struct InputEvent
+		{
+			int frame;
+			u8 key;
+			bool pressed;
+		};
+
+		struct Job
+		{
+			std::string romPath;
+			std::string inputScript;
+			int frameBudget;
+			std::vector<InputEvent> inputEvents;
+			int framesRan;
+			long long instructions;
+			double seconds;
+			bool failed;
+		};
+
+	public:
+		WorkerPool(int threadCount = 0);
+		bool AddJob(const char *romPath, int frameBudget, const char *inputScript = NULL);
+		bool AddJobList(const char *filePath);
+		void Run();
+		void PrintReport();
+
+	private:
+		void Worker(int id);
+		void RunJob(Job &job);
+		static bool LoadInputScript(const char *filePath, std::vector<InputEvent> &events);
+
+	private:
+		std::vector<Job> jobs;
+		std::atomic<size_t> nextJob;
+		std::mutex loadMutex;
+		int threadCount;
+		double wallSeconds;
+};
+
+#endif
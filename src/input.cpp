@@ -9,45 +9,13 @@
 
 // includes
 #include "includes/bit.h"
-#include "includes/cpu.h"
-#include "includes/debugger.h"
-#include "includes/input.h"
-#include "includes/interrupts.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/memory.h"
-
-// definitions
-#define P15 5 // buttons
-#define P14 4 // directional keys
-#define BTN_START 7
-#define BTN_SELECT 6
-#define BTN_B 5
-#define BTN_A 4
-#define DIR_DOWN 3
-#define DIR_UP 2
-#define DIR_LEFT 1
-#define DIR_RIGHT 0
-#define JOYSTICK_DEAD_ZONE 8000
-
-// init vars
-u8 Input::buttons = 0xFF;
-static SDL_GameController *gamePad;
-
-// responsible for handling added controllers
-static void ControllerAdded(int id)
+
+// responsible for constructing the input
+Input::Input(GameBoy &gb) : gb(gb), buttons(0xFF), held(0xFF)
 {
-	if (SDL_IsGameController(id))
-	{
-		gamePad = SDL_GameControllerOpen(id);
-
-		// todo: user configurable input
-		/*
-		if (pad != NULL)
-		{
-			//SDL_Joystick *joy = SDL_GameControllerGetJoystick(pad);
-			//int instanceID = SDL_JoystickInstanceID(joy);
-		}*/
-	}
+
 }
 
 // responsible for initializing the input
@@ -69,10 +37,10 @@ void Input::PressDirection(u8 bit, u8 keyType)
 		case DIR_RIGHT: ReleaseKey(DIR_LEFT); break;
 	}
 
-	Cpu::stopped = false;
+	gb.cpu.stopped = false;
 	Bit::Clear(buttons, bit);
 
-	if (wasNotSet) Interrupts::Request(Interrupts::JOYPAD);
+	if (wasNotSet) gb.interrupts.Request(Interrupts::JOYPAD);
 }
 
 // responsible for pressing a button key
@@ -80,10 +48,10 @@ void Input::PressButton(u8 bit, u8 keyType)
 {
 	const bool wasSet = Bit::Get(buttons, bit);
 
-	Cpu::stopped = false;
+	gb.cpu.stopped = false;
 	Bit::Clear(buttons, bit);
 
-	if (wasSet) Interrupts::Request(Interrupts::JOYPAD);
+	if (wasSet) gb.interrupts.Request(Interrupts::JOYPAD);
 }
 
 // responsible for releasing a key
@@ -92,6 +60,70 @@ void Input::ReleaseKey(u8 bit)
 	Bit::Set(buttons, bit);
 }
 
+// responsible for pressing/releasing a key without a frontend (ie. from an input script)
+void Input::SetKey(u8 bit, bool pressed)
+{
+	// every change goes into a movie, as a press and release between two frames still requests the joypad interrupt
+	gb.movie.RecordKey(bit, pressed);
+
+	if (!pressed) ReleaseKey(bit);
+	else if (bit <= DIR_DOWN) PressDirection(bit, P14);
+	else PressButton(bit, P15);
+}
+
+// responsible for queueing a key press/release from the frontend thread
+void Input::QueueKey(u8 bit, bool pressed)
+{
+	KeyEvent event = {bit, pressed};
+
+	if (!keyQueue.Push(event)) Log::Critical("Input queue is full, dropping key %d", bit);
+}
+
+// responsible for applying the queued key events (called from the emulation thread)
+void Input::ProcessQueuedKeys()
+{
+	KeyEvent event;
+	bool applied = false;
+
+	while (keyQueue.Pop(event))
+	{
+		if (event.pressed) Bit::Clear(held, event.key); else Bit::Set(held, event.key);
+
+		// a movie being played owns the joypad
+		if (gb.movie.IsPlaying()) continue;
+
+		SetKey(event.key, event.pressed);
+		applied = true;
+	}
+
+	// rewind rebuilds states by running steps again, so it can't run across a key change
+	if (applied) gb.rewind.Capture();
+}
+
+// responsible for pressing/releasing keys until they match the ones the frontend has down, ie. after a rewind (returns whether any changed)
+bool Input::HoldKeys()
+{
+	if (gb.movie.IsPlaying() || buttons == held) return false;
+
+	SetButtons(held);
+
+	return true;
+}
+
+// responsible for pressing/releasing keys until the held keys match the mask
+void Input::SetButtons(u8 mask)
+{
+	for (u8 i = 0; i < 8; i++)
+	{
+		if (Bit::Get(mask, i) && !Bit::Get(buttons, i)) SetKey(i, false);
+	}
+
+	for (u8 i = 0; i < 8; i++)
+	{
+		if (!Bit::Get(mask, i) && Bit::Get(buttons, i)) SetKey(i, true);
+	}
+}
+
 // responsible for retrieving the currently pressed key
 u8 Input::GetKey(u8 data)
 {
@@ -103,116 +135,8 @@ u8 Input::GetKey(u8 data)
 	return 0xFF;
 }
 
-// responsible for handling key input
-void Input::HandleKeys(SDL_Event event)
+// responsible for saving/loading the input state
+void Input::Serialize(StateBuffer &state)
 {
-	switch(event.type)
-	{
-		case SDL_CONTROLLERDEVICEADDED:
-			ControllerAdded(event.cdevice.which);
-		break;
-
-		case SDL_JOYAXISMOTION:
-			if (event.jaxis.which == 0)
-			{
-				// x axis
-				if (event.jaxis.axis == 0)
-				{
-					// left
-					if (event.jaxis.value < -JOYSTICK_DEAD_ZONE)
-					{
-						PressDirection(DIR_LEFT, P14);
-					}
-					// right
-					else if (event.jaxis.value > JOYSTICK_DEAD_ZONE)
-					{
-						PressDirection(DIR_RIGHT, P14);
-					}
-					else
-					{
-						ReleaseKey(DIR_LEFT);
-						ReleaseKey(DIR_RIGHT);
-					}
-				}
-				// y axis
-				else if (event.jaxis.axis == 1)
-				{
-					// up
-					if (event.jaxis.value < -JOYSTICK_DEAD_ZONE)
-					{
-						PressDirection(DIR_UP, P14);
-					}
-					// down
-					else if (event.jaxis.value > JOYSTICK_DEAD_ZONE)
-					{
-						PressDirection(DIR_DOWN, P14);
-					}
-					else
-					{
-						ReleaseKey(DIR_UP);
-						ReleaseKey(DIR_DOWN);
-					}
-				}
-			}
-		break;
-
-		case SDL_CONTROLLERBUTTONDOWN:
-			switch(event.cbutton.button)
-			{
-				case SDL_CONTROLLER_BUTTON_DPAD_LEFT: PressDirection(DIR_LEFT, P14); break;
-				case SDL_CONTROLLER_BUTTON_DPAD_RIGHT: PressDirection(DIR_RIGHT, P14); break;
-				case SDL_CONTROLLER_BUTTON_DPAD_UP: PressDirection(DIR_UP, P14); break;
-				case SDL_CONTROLLER_BUTTON_DPAD_DOWN: PressDirection(DIR_DOWN, P14); break;
-				case SDL_CONTROLLER_BUTTON_A: PressButton(BTN_B, P15); break;
-				case SDL_CONTROLLER_BUTTON_B: PressButton(BTN_A, P15); break;
-				case SDL_CONTROLLER_BUTTON_BACK: PressButton(BTN_SELECT, P15); break;
-				case SDL_CONTROLLER_BUTTON_START: PressButton(BTN_START, P15); break;
-				case SDL_CONTROLLER_BUTTON_LEFTSHOULDER: Cpu::SaveState(false); break;
-				case SDL_CONTROLLER_BUTTON_RIGHTSHOULDER: Cpu::LoadState(false); break;
-				case SDL_CONTROLLER_BUTTON_GUIDE: Debugger::stepThrough = !Debugger::stepThrough; break;
-			}
-		break;
-
-		case SDL_CONTROLLERBUTTONUP:
-			switch(event.cbutton.button)
-			{
-				case SDL_CONTROLLER_BUTTON_DPAD_LEFT: ReleaseKey(DIR_LEFT); break;
-				case SDL_CONTROLLER_BUTTON_DPAD_RIGHT: ReleaseKey(DIR_RIGHT); break;
-				case SDL_CONTROLLER_BUTTON_DPAD_UP: ReleaseKey(DIR_UP); break;
-				case SDL_CONTROLLER_BUTTON_DPAD_DOWN: ReleaseKey(DIR_DOWN); break;
-				case SDL_CONTROLLER_BUTTON_A: ReleaseKey(BTN_B); break;
-				case SDL_CONTROLLER_BUTTON_B: ReleaseKey(BTN_A); break;
-				case SDL_CONTROLLER_BUTTON_BACK: ReleaseKey(BTN_SELECT); break;
-				case SDL_CONTROLLER_BUTTON_START: ReleaseKey(BTN_START); break;
-			}
-		break;
-
-		case SDL_KEYDOWN:
-			switch(event.key.keysym.sym)
-			{
-				case SDLK_LEFT: PressDirection(DIR_LEFT, P14); break;
-				case SDLK_RIGHT: PressDirection(DIR_RIGHT, P14); break;
-				case SDLK_UP: PressDirection(DIR_UP, P14); break;
-				case SDLK_DOWN: PressDirection(DIR_DOWN, P14); break;
-				case SDLK_z: PressButton(BTN_B, P15); break;
-				case SDLK_x: PressButton(BTN_A, P15); break;
-				case SDLK_RSHIFT: PressButton(BTN_SELECT, P15); break;
-				case SDLK_RETURN: PressButton(BTN_START, P15); break;
-			}
-		break;
-
-		case SDL_KEYUP:
-			switch(event.key.keysym.sym)
-			{
-				case SDLK_LEFT: ReleaseKey(DIR_LEFT); break;
-				case SDLK_RIGHT: ReleaseKey(DIR_RIGHT); break;
-				case SDLK_UP: ReleaseKey(DIR_UP); break;
-				case SDLK_DOWN: ReleaseKey(DIR_DOWN); break;
-				case SDLK_z: ReleaseKey(BTN_B); break;
-				case SDLK_x: ReleaseKey(BTN_A); break;
-				case SDLK_RSHIFT: ReleaseKey(BTN_SELECT); break;
-				case SDLK_RETURN: ReleaseKey(BTN_START); break;
-			}
-		break;
-	}
+	state.Value(buttons);
 }
@@ -0,0 +1,151 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include <SDL2/SDL.h>
+#include "includes/emulationThread.h"
+#include "includes/input.h"
+#include "includes/ui.h"
+
+// definitions
+#define JOYSTICK_DEAD_ZONE 8000
+
+// init vars
+static SDL_GameController *gamePad;
+
+// responsible for handling added controllers
+static void ControllerAdded(int id)
+{
+	if (SDL_IsGameController(id))
+	{
+		gamePad = SDL_GameControllerOpen(id);
+
+		// todo: user configurable input
+		/*
+		if (pad != NULL)
+		{
+			//SDL_Joystick *joy = SDL_GameControllerGetJoystick(pad);
+			//int instanceID = SDL_JoystickInstanceID(joy);
+		}*/
+	}
+}
+
+// responsible for handling key input
+void Input::HandleKeys(const SDL_Event &event)
+{
+	switch(event.type)
+	{
+		case SDL_CONTROLLERDEVICEADDED:
+			ControllerAdded(event.cdevice.which);
+		break;
+
+		case SDL_JOYAXISMOTION:
+			if (event.jaxis.which == 0)
+			{
+				// x axis
+				if (event.jaxis.axis == 0)
+				{
+					// left
+					if (event.jaxis.value < -JOYSTICK_DEAD_ZONE)
+					{
+						QueueKey(DIR_LEFT, true);
+					}
+					// right
+					else if (event.jaxis.value > JOYSTICK_DEAD_ZONE)
+					{
+						QueueKey(DIR_RIGHT, true);
+					}
+					else
+					{
+						QueueKey(DIR_LEFT, false);
+						QueueKey(DIR_RIGHT, false);
+					}
+				}
+				// y axis
+				else if (event.jaxis.axis == 1)
+				{
+					// up
+					if (event.jaxis.value < -JOYSTICK_DEAD_ZONE)
+					{
+						QueueKey(DIR_UP, true);
+					}
+					// down
+					else if (event.jaxis.value > JOYSTICK_DEAD_ZONE)
+					{
+						QueueKey(DIR_DOWN, true);
+					}
+					else
+					{
+						QueueKey(DIR_UP, false);
+						QueueKey(DIR_DOWN, false);
+					}
+				}
+			}
+		break;
+
+		case SDL_CONTROLLERBUTTONDOWN:
+			switch(event.cbutton.button)
+			{
+				case SDL_CONTROLLER_BUTTON_DPAD_LEFT: QueueKey(DIR_LEFT, true); break;
+				case SDL_CONTROLLER_BUTTON_DPAD_RIGHT: QueueKey(DIR_RIGHT, true); break;
+				case SDL_CONTROLLER_BUTTON_DPAD_UP: QueueKey(DIR_UP, true); break;
+				case SDL_CONTROLLER_BUTTON_DPAD_DOWN: QueueKey(DIR_DOWN, true); break;
+				case SDL_CONTROLLER_BUTTON_A: QueueKey(BTN_B, true); break;
+				case SDL_CONTROLLER_BUTTON_B: QueueKey(BTN_A, true); break;
+				case SDL_CONTROLLER_BUTTON_BACK: QueueKey(BTN_SELECT, true); break;
+				case SDL_CONTROLLER_BUTTON_START: QueueKey(BTN_START, true); break;
+				case SDL_CONTROLLER_BUTTON_LEFTSHOULDER: Ui::SaveState(); break;
+				case SDL_CONTROLLER_BUTTON_RIGHTSHOULDER: Ui::LoadState(); break;
+				case SDL_CONTROLLER_BUTTON_GUIDE: EmulationThread::SendCommand(EmulationThread::TogglePause); break;
+			}
+		break;
+
+		case SDL_CONTROLLERBUTTONUP:
+			switch(event.cbutton.button)
+			{
+				case SDL_CONTROLLER_BUTTON_DPAD_LEFT: QueueKey(DIR_LEFT, false); break;
+				case SDL_CONTROLLER_BUTTON_DPAD_RIGHT: QueueKey(DIR_RIGHT, false); break;
+				case SDL_CONTROLLER_BUTTON_DPAD_UP: QueueKey(DIR_UP, false); break;
+				case SDL_CONTROLLER_BUTTON_DPAD_DOWN: QueueKey(DIR_DOWN, false); break;
+				case SDL_CONTROLLER_BUTTON_A: QueueKey(BTN_B, false); break;
+				case SDL_CONTROLLER_BUTTON_B: QueueKey(BTN_A, false); break;
+				case SDL_CONTROLLER_BUTTON_BACK: QueueKey(BTN_SELECT, false); break;
+				case SDL_CONTROLLER_BUTTON_START: QueueKey(BTN_START, false); break;
+			}
+		break;
+
+		case SDL_KEYDOWN:
+			switch(event.key.keysym.sym)
+			{
+				case SDLK_LEFT: QueueKey(DIR_LEFT, true); break;
+				case SDLK_RIGHT: QueueKey(DIR_RIGHT, true); break;
+				case SDLK_UP: QueueKey(DIR_UP, true); break;
+				case SDLK_DOWN: QueueKey(DIR_DOWN, true); break;
+				case SDLK_z: QueueKey(BTN_B, true); break;
+				case SDLK_x: QueueKey(BTN_A, true); break;
+				case SDLK_RSHIFT: QueueKey(BTN_SELECT, true); break;
+				case SDLK_RETURN: QueueKey(BTN_START, true); break;
+			}
+		break;
+
+		case SDL_KEYUP:
+			switch(event.key.keysym.sym)
+			{
+				case SDLK_LEFT: QueueKey(DIR_LEFT, false); break;
+				case SDLK_RIGHT: QueueKey(DIR_RIGHT, false); break;
+				case SDLK_UP: QueueKey(DIR_UP, false); break;
+				case SDLK_DOWN: QueueKey(DIR_DOWN, false); break;
+				case SDLK_z: QueueKey(BTN_B, false); break;
+				case SDLK_x: QueueKey(BTN_A, false); break;
+				case SDLK_RSHIFT: QueueKey(BTN_SELECT, false); break;
+				case SDLK_RETURN: QueueKey(BTN_START, false); break;
+			}
+		break;
+	}
+}
@@ -9,14 +9,12 @@
 
 // includes
 #include "includes/bit.h"
-#include "includes/cpu.h"
-#include "includes/interrupts.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/memory.h"
 
 // definitions
-#define IF Memory::mem[Memory::Address::IF]
-#define IE Memory::mem[Memory::Address::IE]
+#define IF gb.memory.mem[Memory::Address::IF]
+#define IE gb.memory.mem[Memory::Address::IE]
 
 // init vars
 union InterruptType
@@ -33,11 +31,18 @@ static const InterruptType timer = {{.bit = 2, .address = 0x50}};
 static const InterruptType serial = {{.bit = 3, .address = 0x58}};
 static const InterruptType joypad = {{.bit = 4, .address = 0x60}};
 static const InterruptType interruptList[5] = {vblank, lcd, timer, serial, joypad};
-bool Interrupts::ime = false;
-bool Interrupts::clearIF = true;
-bool Interrupts::shouldExecute = true;
-u8 Interrupts::pendingCount = 0;
-static bool wasHalted = false;
+
+// responsible for constructing the interrupt system
+Interrupts::Interrupts(GameBoy &gb) :
+	ime(false),
+	clearIF(true),
+	shouldExecute(true),
+	pendingCount(0),
+	gb(gb),
+	wasHalted(false)
+{
+
+}
 
 // responsible for initialisizing the interrupt system
 void Interrupts::Init()
@@ -83,8 +88,8 @@ int Interrupts::RequestedId()
 	{
 		if (IsRequested(i) && IsEnabled(i))
 		{
-			wasHalted = Cpu::halted;
-			Cpu::halted = false;
+			wasHalted = gb.cpu.halted;
+			gb.cpu.halted = false;
 			return i;
 		}
 	}
@@ -102,12 +107,23 @@ void Interrupts::Service()
 		if (shouldExecute)
 		{
 			Reset(id);
-			Memory::Push(Cpu::pc);
+			STATS(gb.stats.interrupts[id] += 1);
+			gb.memory.Push(gb.cpu.pc);
 
-			Cpu::cycles += (wasHalted) ? 24 : 20;
-			Cpu::pc.reg = interruptList[id].address;
+			gb.cpu.cycles += (wasHalted) ? 24 : 20;
+			gb.cpu.pc.reg = interruptList[id].address;
 			wasHalted = false;
 			ime = false;
 		}
 	}
 }
+
+// responsible for saving/loading the interrupt state
+void Interrupts::Serialize(StateBuffer &state)
+{
+	state.Value(ime);
+	state.Value(clearIF);
+	state.Value(shouldExecute);
+	state.Value(pendingCount);
+	state.Value(wasHalted);
+}
@@ -8,68 +8,120 @@
  */
 
 // includes
-#include <SDL2/SDL_opengl.h>
+#include <string.h>
 #include "includes/bit.h"
-#include "includes/interrupts.h"
-#include "includes/lcd.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/memory.h"
+#include "includes/profiler.h"
 
 // definitions
 #define LCD_CLOCK_CYCLES 456
-#define LY Memory::mem[Memory::Address::LY]
-#define LYC Memory::ReadByte(Memory::Address::LYC)
-#define LCDC Memory::mem[Memory::Address::LCDC]
-#define STAT Memory::mem[Memory::Address::STAT]
-#define BGP Memory::mem[Memory::Address::BGP]
-#define OP0 Memory::mem[Memory::Address::OP0]
-#define OP1 Memory::mem[Memory::Address::OP1]
-#define SCY Memory::ReadByte(Memory::Address::SCY)
-#define SCX Memory::ReadByte(Memory::Address::SCX)
-#define WY Memory::ReadByte(Memory::Address::WY)
-#define WX Memory::ReadByte(Memory::Address::WX)
+#define LCD_VBLANK_LINE 144
+#define LCD_OAM_CYCLES (LCD_CLOCK_CYCLES - 80)
+#define LCD_TRANSFER_CYCLES (LCD_OAM_CYCLES - 172)
+#define LCD_BLANK_SHADE 4
+#define LY gb.memory.mem[Memory::Address::LY]
+#define LYC gb.memory.mem[Memory::Address::LYC]
+#define LCDC gb.memory.mem[Memory::Address::LCDC]
+#define STAT gb.memory.mem[Memory::Address::STAT]
+#define BGP gb.memory.mem[Memory::Address::BGP]
+#define OP0 gb.memory.mem[Memory::Address::OP0]
+#define OP1 gb.memory.mem[Memory::Address::OP1]
+#define SCY gb.memory.mem[Memory::Address::SCY]
+#define SCX gb.memory.mem[Memory::Address::SCX]
+#define WY gb.memory.mem[Memory::Address::WY]
+#define WX gb.memory.mem[Memory::Address::WX]
 
 // init vars
-u8 Lcd::screen[144][160][3];
-int Lcd::height = 480;
-int Lcd::width = 640;
-int Lcd::scanlineCounter = 0;
-static const Lcd::Rgb colorPalette[4] =
+// the four shades, plus the black the screen shows before anything has been drawn
+static const Lcd::Rgb colorPalette[5] =
 {
-	{155, 188, 15}, {139, 172, 15}, {48, 98, 48}, {15, 56, 15}
+	{155, 188, 15}, {139, 172, 15}, {48, 98, 48}, {15, 56, 15}, {0, 0, 0}
 };
-static GLuint texture;
+
+// spreads the bits of a tile byte two apart, so a pair of bytes interleaves into eight 2 bit colour numbers
+static const u16 tileRowLut[256] =
+{
+	0x0000, 0x0001, 0x0004, 0x0005, 0x0010, 0x0011, 0x0014, 0x0015, 0x0040, 0x0041, 0x0044, 0x0045, 0x0050, 0x0051, 0x0054, 0x0055, // 00
+	0x0100, 0x0101, 0x0104, 0x0105, 0x0110, 0x0111, 0x0114, 0x0115, 0x0140, 0x0141, 0x0144, 0x0145, 0x0150, 0x0151, 0x0154, 0x0155, // 10
+	0x0400, 0x0401, 0x0404, 0x0405, 0x0410, 0x0411, 0x0414, 0x0415, 0x0440, 0x0441, 0x0444, 0x0445, 0x0450, 0x0451, 0x0454, 0x0455, // 20
+	0x0500, 0x0501, 0x0504, 0x0505, 0x0510, 0x0511, 0x0514, 0x0515, 0x0540, 0x0541, 0x0544, 0x0545, 0x0550, 0x0551, 0x0554, 0x0555, // 30
+	0x1000, 0x1001, 0x1004, 0x1005, 0x1010, 0x1011, 0x1014, 0x1015, 0x1040, 0x1041, 0x1044, 0x1045, 0x1050, 0x1051, 0x1054, 0x1055, // 40
+	0x1100, 0x1101, 0x1104, 0x1105, 0x1110, 0x1111, 0x1114, 0x1115, 0x1140, 0x1141, 0x1144, 0x1145, 0x1150, 0x1151, 0x1154, 0x1155, // 50
+	0x1400, 0x1401, 0x1404, 0x1405, 0x1410, 0x1411, 0x1414, 0x1415, 0x1440, 0x1441, 0x1444, 0x1445, 0x1450, 0x1451, 0x1454, 0x1455, // 60
+	0x1500, 0x1501, 0x1504, 0x1505, 0x1510, 0x1511, 0x1514, 0x1515, 0x1540, 0x1541, 0x1544, 0x1545, 0x1550, 0x1551, 0x1554, 0x1555, // 70
+	0x4000, 0x4001, 0x4004, 0x4005, 0x4010, 0x4011, 0x4014, 0x4015, 0x4040, 0x4041, 0x4044, 0x4045, 0x4050, 0x4051, 0x4054, 0x4055, // 80
+	0x4100, 0x4101, 0x4104, 0x4105, 0x4110, 0x4111, 0x4114, 0x4115, 0x4140, 0x4141, 0x4144, 0x4145, 0x4150, 0x4151, 0x4154, 0x4155, // 90
+	0x4400, 0x4401, 0x4404, 0x4405, 0x4410, 0x4411, 0x4414, 0x4415, 0x4440, 0x4441, 0x4444, 0x4445, 0x4450, 0x4451, 0x4454, 0x4455, // A0
+	0x4500, 0x4501, 0x4504, 0x4505, 0x4510, 0x4511, 0x4514, 0x4515, 0x4540, 0x4541, 0x4544, 0x4545, 0x4550, 0x4551, 0x4554, 0x4555, // B0
+	0x5000, 0x5001, 0x5004, 0x5005, 0x5010, 0x5011, 0x5014, 0x5015, 0x5040, 0x5041, 0x5044, 0x5045, 0x5050, 0x5051, 0x5054, 0x5055, // C0
+	0x5100, 0x5101, 0x5104, 0x5105, 0x5110, 0x5111, 0x5114, 0x5115, 0x5140, 0x5141, 0x5144, 0x5145, 0x5150, 0x5151, 0x5154, 0x5155, // D0
+	0x5400, 0x5401, 0x5404, 0x5405, 0x5410, 0x5411, 0x5414, 0x5415, 0x5440, 0x5441, 0x5444, 0x5445, 0x5450, 0x5451, 0x5454, 0x5455, // E0
+	0x5500, 0x5501, 0x5504, 0x5505, 0x5510, 0x5511, 0x5514, 0x5515, 0x5540, 0x5541, 0x5544, 0x5545, 0x5550, 0x5551, 0x5554, 0x5555, // F0
+};
+
+// responsible for constructing the Lcd
+Lcd::Lcd(GameBoy &gb) : scanlineCounter(0), frameReady(false), frameSkip(0), renderEnabled(true), running(false), drawing(true), skippedFrames(0), paletteValues(), paletteShades(), frameBuffer(), backgroundColors(), screen(), screenDirty(true), tileCache(), tileDirty(), lineSprites(), lineSpriteCount(), indexedSpriteHeight(0), oamDirty(true), gb(gb)
+{
+
+}
 
 // responsible for initializing the Lcd
 void Lcd::Init()
 {
 	Reset();
-
-	// setup opengl for the game window
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glEnable(GL_TEXTURE_2D);
-	UpdateTexture();
 }
 
 // responsible for resetting the Lcd
 void Lcd::Reset()
 {
 	scanlineCounter = 0;
+	drawing = renderEnabled;
+	skippedFrames = 0;
+
+	// force the palette colours to be worked out again on the next scanline
+	for (int i = 0; i < 3; i++)
+	{
+		paletteValues[i] = -1;
+	}
+
+	FlushTiles();
+	InvalidateOam();
+
+	memset(frameBuffer, LCD_BLANK_SHADE, sizeof(frameBuffer));
+	screenDirty = true;
+
+	// let the frontend pick up the cleared screen
+	frameReady = true;
+}
+
+// responsible for returning the frame buffer (a shade index per pixel)
+const u8 *Lcd::GetFrameBuffer()
+{
+	return &frameBuffer[0][0];
+}
 
-	for (int y = 0; y < 144; y++)
+// responsible for returning the screen as rgb (only converting the frame buffer when it has changed)
+const u8 *Lcd::GetScreen()
+{
+	if (screenDirty)
 	{
-		for (int x = 0; x < 160; x++)
+		for (int y = 0; y < 144; y++)
 		{
-			screen[y][x][0] = 0;
-			screen[y][x][1] = 0;
-			screen[y][x][2] = 0;
+			for (int x = 0; x < 160; x++)
+			{
+				const Rgb &pixelColor = colorPalette[frameBuffer[y][x]];
+
+				screen[y][x][0] = pixelColor.r;
+				screen[y][x][1] = pixelColor.g;
+				screen[y][x][2] = pixelColor.b;
+			}
 		}
+
+		screenDirty = false;
 	}
+
+	return &screen[0][0][0];
 }
 
 // responsible for determining if the Lcd display is enabled
@@ -81,6 +133,8 @@ bool Lcd::Enabled()
 // responsible for updating the Lcd controller
 void Lcd::Update(int cycles)
 {
+	PROFILE_SECTION(Profiler::LCD);
+
 	SetStatus();
 
 	if (!Enabled()) return;
@@ -91,11 +145,15 @@ void Lcd::Update(int cycles)
 	{
 		switch(LY)
 		{
-			case 0 ... 143: DrawScanline(); break;
+			case 0 ... 143: if (drawing) DrawScanline(); break;
 
 			case 144:
-				UpdateTexture();
-				Interrupts::Request(Interrupts::VBLANK);
+				if (drawing) frameReady = true;
+				gb.interrupts.Request(Interrupts::VBLANK);
+
+				// work out whether the next frame gets drawn or skipped
+				skippedFrames = (drawing) ? 0 : (skippedFrames + 1);
+				drawing = (renderEnabled && skippedFrames >= frameSkip);
 			break;
 
 			case 154: LY = 0xFF; break;
@@ -104,13 +162,39 @@ void Lcd::Update(int cycles)
 		LY += 1;
 
 		if (LY == LYC) Bit::Set(STAT, 2); else Bit::Clear(STAT, 2);
-		if (Bit::Get(STAT, 2) && Bit::Get(STAT, 6)) Interrupts::Request(Interrupts::LCD);
+		if (Bit::Get(STAT, 2) && Bit::Get(STAT, 6)) gb.interrupts.Request(Interrupts::LCD);
 
 		STAT |= 0x80;
 		scanlineCounter -= LCD_CLOCK_CYCLES;
 	}
 }
 
+// responsible for adding cycles that passed without an event to the scanline counter
+void Lcd::Advance(int cycles)
+{
+	if (running) scanlineCounter += cycles;
+}
+
+// responsible for working out how many cycles until the mode or line next changes
+int Lcd::NextEvent()
+{
+	// LCDC and STAT can only change by being written to, which syncs the scheduler
+	running = Enabled();
+
+	if (!running) return LCD_CLOCK_CYCLES;
+
+	// the mode is set from the counter at the start of a step, so it catches up on the next one
+	if (GetMode() != (STAT & 0x3)) return 0;
+
+	if (LY < LCD_VBLANK_LINE)
+	{
+		if (scanlineCounter < LCD_TRANSFER_CYCLES) return (LCD_TRANSFER_CYCLES - scanlineCounter);
+		if (scanlineCounter < LCD_OAM_CYCLES) return (LCD_OAM_CYCLES - scanlineCounter);
+	}
+
+	return (LCD_CLOCK_CYCLES - scanlineCounter);
+}
+
 // responsible for setting the Lcd mode
 u8 Lcd::SetMode(u8 mode)
 {
@@ -127,15 +211,25 @@ u8 Lcd::SetMode(u8 mode)
 	return mode;
 }
 
+// responsible for working out which mode the Lcd should be in
+u8 Lcd::GetMode()
+{
+	if (LY >= LCD_VBLANK_LINE) return 1;
+
+	switch(scanlineCounter)
+	{
+		case LCD_OAM_CYCLES ... LCD_CLOCK_CYCLES: return 2;
+		case LCD_TRANSFER_CYCLES ... (LCD_OAM_CYCLES - 1): return 3;
+		default: return 0;
+	}
+}
+
 // responsible for setting the Lcd status
 void Lcd::SetStatus()
 {
 	bool requestInterrupt = false;
 	u8 nextMode = 0;
 	const u8 currentMode = (STAT & 0x3);
-	const u16 vblankRange = 144;
-	const u16 oamRange = (LCD_CLOCK_CYCLES - 80);
-	const u16 dataToLcd = (oamRange - 172);
 
 	if (!Enabled())
 	{
@@ -146,54 +240,21 @@ void Lcd::SetStatus()
 		return;
 	}
 
-	if (LY >= vblankRange)
-	{
-		nextMode = SetMode(1);
-		requestInterrupt = Bit::Get(STAT, 4);
-	}
-	else
-	{
-		switch(scanlineCounter)
-		{
-			case oamRange ... LCD_CLOCK_CYCLES:
-				nextMode = SetMode(2);
-				requestInterrupt = Bit::Get(STAT, 5);
-			break;
-
-			case dataToLcd ... (oamRange - 1):
-				nextMode = SetMode(3);
-			break;
+	nextMode = SetMode(GetMode());
 
-			default:
-				nextMode = SetMode(0);
-				requestInterrupt = Bit::Get(STAT, 3);
-			break;
-		}
+	switch(nextMode)
+	{
+		case 0: requestInterrupt = Bit::Get(STAT, 3); break;
+		case 1: requestInterrupt = Bit::Get(STAT, 4); break;
+		case 2: requestInterrupt = Bit::Get(STAT, 5); break;
 	}
 
 	if (requestInterrupt && (nextMode != currentMode))
 	{
-		Interrupts::Request(Interrupts::LCD);
+		gb.interrupts.Request(Interrupts::LCD);
 	}
 }
 
-// responsible for updating the screen texture
-void Lcd::UpdateTexture()
-{
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 160, 144, 0, GL_RGB, GL_UNSIGNED_BYTE, screen);
-}
-
-// responsible for rendering the image to the screen
-void Lcd::Render()
-{
-	glBegin(GL_QUADS);
-	glTexCoord2f(0, 0); glVertex2f(0, 0);
-	glTexCoord2f(0, 1); glVertex2f(0, height);
-	glTexCoord2f(1, 1); glVertex2f(width, height);
-	glTexCoord2f(1, 0); glVertex2f(width, 0);
-	glEnd();
-}
-
 // responsible for determining if the background is enabled
 bool Lcd::IsBackgroundEnabled()
 {
@@ -212,67 +273,180 @@ bool Lcd::IsSpritesEnabled()
 	return Bit::Get(LCDC, 1);
 }
 
-// responsible for getting a color from a palette
-Lcd::Rgb Lcd::GetColor(u8 palette, u8 bit)
+// responsible for rebuilding the shade lookups for any palette register that has changed since the last scanline
+void Lcd::UpdatePalettes()
 {
-	const u8 hi = ((bit << 1) + 1);
-	const u8 lo = (bit << 1);
-	const u8 color = ((Bit::Get(palette, hi) << 1) | (Bit::Get(palette, lo)));
+	const u8 palettes[3] = {BGP, OP0, OP1};
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (palettes[i] == paletteValues[i]) continue;
 
-	return colorPalette[color];
+		for (u8 color = 0; color < 4; color++)
+		{
+			paletteShades[i][color] = ((palettes[i] >> (color << 1)) & 0x3);
+		}
+
+		paletteValues[i] = palettes[i];
+	}
+}
+
+// responsible for decoding a tile row into 2 bit colour numbers (leftmost pixel in the top two bits)
+u16 Lcd::DecodeTileRow(u8 lo, u8 hi)
+{
+	return (tileRowLut[lo] | (tileRowLut[hi] << 1));
+}
+
+// responsible for marking the tile containing a vram address as needing decoding again
+void Lcd::InvalidateTile(u16 address)
+{
+	tileDirty[(address - Memory::Address::TILE_DATA_START) >> 4] = true;
+}
+
+// responsible for marking every tile as needing decoding again (ie. after vram is replaced wholesale)
+void Lcd::FlushTiles()
+{
+	for (int i = 0; i < 384; i++)
+	{
+		tileDirty[i] = true;
+	}
+}
+
+// responsible for returning one row of a tile as colour numbers (decoding the tile first if vram has changed)
+const u8 *Lcd::GetTileRow(int tile, u8 row, bool xFlip)
+{
+	if (tileDirty[tile])
+	{
+		const u8 *tileData = &gb.memory.mem[Memory::Address::TILE_DATA_START + (tile * 16)];
+
+		for (u8 y = 0; y < 8; y++)
+		{
+			const u16 pixels = DecodeTileRow(tileData[y * 2], tileData[(y * 2) + 1]);
+
+			for (u8 x = 0; x < 8; x++)
+			{
+				const u8 colorNum = ((pixels >> ((7 - x) * 2)) & 0x3);
+
+				tileCache[0][tile][y][x] = colorNum;
+				tileCache[1][tile][y][7 - x] = colorNum;
+			}
+		}
+
+		tileDirty[tile] = false;
+	}
+
+	return tileCache[xFlip][tile][row];
 }
 
 // responsible for drawing the current scanline
 void Lcd::DrawScanline()
 {
+	PROFILE_SECTION(Profiler::LCD_DRAW);
+
+	UpdatePalettes();
 	DrawBackground();
 	DrawSprites();
+
+	screenDirty = true;
 }
 
-// responsible for drawing the background
+// responsible for drawing the background and window
 void Lcd::DrawBackground()
 {
-	if (!IsBackgroundEnabled()) return;
+	if (!IsBackgroundEnabled())
+	{
+		// with no background, sprites always show
+		memset(backgroundColors, 0, sizeof(backgroundColors));
+		return;
+	}
+
+	const u8 line = LY;
+	const u8 windowY = WY;
+	const int windowX = (WX - 7);
+	const u16 tileMemory = Bit::Get(LCDC, 3) ? 0x9C00 : 0x9800;
+	const u16 windowMemory = Bit::Get(LCDC, 6) ? 0x9C00 : 0x9800;
+	int windowStart = 160;
+
+	if (IsWindowEnabled() && line >= windowY) windowStart = (windowX < 0) ? 0 : windowX;
+	if (windowStart > 160) windowStart = 160;
 
-	u16 tileMemory = Bit::Get(LCDC, 3) ? 0x9C00 : 0x9800;
-	const u16 tileData = Bit::Get(LCDC, 4) ? 0x8000 : 0x8800;
-	const u16 tileMemoryAddress = tileMemory;
-	const u16 windowMemoryAddress = Bit::Get(LCDC, 6) ? 0x9C00 : 0x9800;
+	DrawTiles(0, windowStart, tileMemory, (SCY + line), SCX);
+	DrawTiles(windowStart, 160, windowMemory, (line - windowY), windowX);
+}
+
+// responsible for drawing the pixels between start and end from a tile map (pixel x comes from column xOffset + x)
+void Lcd::DrawTiles(int start, int end, u16 tileMemory, u8 yPos, u8 xOffset)
+{
+	const u8 *mem = gb.memory.mem;
+	const u8 line = LY;
 	const bool unsignedTile = Bit::Get(LCDC, 4);
-	const bool windowEnabled = IsWindowEnabled();
+	const u16 tileRow = (tileMemory + ((yPos / 8) * 32));
+	const u8 tileYLine = (yPos % 8);
+	const u8 *palette = paletteShades[0];
+	int x = start;
 
-	for (u8 x = 0; x < 160; x++)
+	while (x < end)
 	{
-		u8 yPos = (SCY + LY);
-		u8 xPos = (SCX + x);
+		const u8 xPos = (xOffset + x);
+		const u8 tileNum = mem[tileRow + (xPos / 8)];
+		const int tile = (unsignedTile) ? tileNum : (256 + (s8)tileNum);
+		const u8 *pixels = GetTileRow(tile, tileYLine, false);
 
-		if (windowEnabled && (LY >= WY) && (x >= (WX - 7)))
+		// draw every pixel of the row that lands in this span
+		for (u8 pixel = (xPos % 8); pixel < 8 && x < end; pixel++, x++)
 		{
-			tileMemory = windowMemoryAddress;
-			yPos = (LY - WY);
-			xPos = ((WX - 7) + x);
+			backgroundColors[x] = pixels[pixel];
+			frameBuffer[line][x] = palette[pixels[pixel]];
 		}
-		else
+	}
+}
+
+// responsible for working out which sprites land on each line, in the order they take priority
+void Lcd::IndexSprites(u8 spriteHeight)
+{
+	const u8 *attributes = &gb.memory.mem[Memory::Address::OAM_START];
+
+	for (int line = 0; line < 144; line++)
+	{
+		lineSpriteCount[line] = 0;
+	}
+
+	// the first sprites in oam claim the slots on each line
+	for (u8 i = 0; i < 40; i++)
+	{
+		const u8 yPos = attributes[(i * 4)] - 16;
+		const u8 xPos = attributes[(i * 4) + 1] - 8;
+
+		// sprites at position 0 are not drawn
+		if (xPos == 0 && yPos == 0) continue;
+
+		for (int line = yPos; line < (yPos + spriteHeight) && line < 144; line++)
 		{
-			tileMemory = tileMemoryAddress;
-		}
+			u8 *sprites = lineSprites[line];
+			int slot = lineSpriteCount[line];
+
+			if (slot >= LCD_MAX_LINE_SPRITES) continue;
 
-		const u16 tileCol = (xPos / 8);
-		const u16 tileRow = ((yPos / 8) * 32);
-		const u8 tileYLine = ((yPos % 8) * 2);
-		const u16 tileAddress = (tileMemory + tileCol + tileRow);
-		const s16 tileNum = (unsignedTile) ? (u8)Memory::ReadByte(tileAddress) : (s8)Memory::ReadByte(tileAddress);
-		const u16 tileLocation = (unsignedTile) ? (tileData +  (tileNum * 16)) : ((tileData) + ((tileNum  + 128) * 16));
-		const u8 pixelData1 = Memory::ReadByte(tileLocation + tileYLine);
-		const u8 pixelData2 = Memory::ReadByte(tileLocation + tileYLine + 1);
-		const u8 colorBit = (((xPos % 8) - 7) * -1);
-		const u8 colorNum = ((Bit::Get(pixelData2, colorBit) << 1) | (Bit::Get(pixelData1, colorBit)));
-		const Rgb pixelColor = GetColor(BGP, colorNum);
-
-		screen[LY][x][0] = pixelColor.r;
-		screen[LY][x][1] = pixelColor.g;
-		screen[LY][x][2] = pixelColor.b;
+			// the sprite furthest left wins, then the one first in oam
+			while (slot > 0 && attributes[(sprites[slot - 1] * 4) + 1] > attributes[(i * 4) + 1])
+			{
+				sprites[slot] = sprites[slot - 1];
+				slot -= 1;
+			}
+
+			sprites[slot] = i;
+			lineSpriteCount[line] += 1;
+		}
 	}
+
+	indexedSpriteHeight = spriteHeight;
+	oamDirty = false;
+}
+
+// responsible for marking the sprite index as out of date (ie. after an oam write or dma)
+void Lcd::InvalidateOam()
+{
+	oamDirty = true;
 }
 
 // responsible for drawing sprites
@@ -280,54 +454,67 @@ void Lcd::DrawSprites()
 {
 	if (!IsSpritesEnabled()) return;
 
-	const u16 spriteData = 0x8000;
-	const u16 spriteAttributeData = 0xFE00;
-	const u8 spriteWidth = 8;
+	const u8 *mem = gb.memory.mem;
+	const u8 line = LY;
 	const u8 spriteHeight = Bit::Get(LCDC, 2) ? 16 : 8;
-	const u8 spriteLimit = 40;
 
-	for (int i = (spriteLimit - 1); i >= 0; i--)
-	{
-		const u8 index = (i * 4);
-		const u8 yPos = Memory::ReadByte(spriteAttributeData + index) - 16;
-		const u8 xPos = Memory::ReadByte(spriteAttributeData + index + 1) - 8;
-		u8 patternNo = Memory::ReadByte(spriteAttributeData + index + 2);
-		const u8 flags = Memory::ReadByte(spriteAttributeData + index + 3);
-
-		if (spriteHeight == 16) Bit::Clear(patternNo, 0);
-
-		const u8 priority = Bit::Get(flags, 7);
-		const u8 yFlip = Bit::Get(flags, 6);
-		const u8 xFlip = Bit::Get(flags, 5);
-		const u8 palette = (Bit::Get(flags, 4)) ? OP1 : OP0;
-		const u8 line = (yFlip) ? ((((LY - yPos - spriteHeight) + 1) * -1) * 2) : ((LY - yPos) * 2);
-		const u8 pixelData1 = Memory::ReadByte(spriteData + (patternNo * 16) + line);
-		const u8 pixelData2 = Memory::ReadByte(spriteData + (patternNo * 16) + line + 1);
+	bool covered[160] = {false};
 
-		// sprites at position 0 are not drawn
-		if (xPos == 0 && yPos == 0) continue;
+	if (oamDirty || spriteHeight != indexedSpriteHeight) IndexSprites(spriteHeight);
 
-		if (LY >= yPos && LY < (yPos + spriteHeight))
+	// the highest priority sprite goes first, and owns every pixel it isn't transparent on
+	for (int i = 0; i < lineSpriteCount[line]; i++)
+	{
+		const u8 *attributes = &mem[Memory::Address::OAM_START + (lineSprites[line][i] * 4)];
+		const u8 yPos = attributes[0] - 16;
+		const u8 xPos = attributes[1] - 8;
+		const u8 patternNo = (spriteHeight == 16) ? (attributes[2] & 0xFE) : attributes[2];
+		const u8 flags = attributes[3];
+		const bool priority = Bit::Get(flags, 7);
+		const bool yFlip = Bit::Get(flags, 6);
+		const bool xFlip = Bit::Get(flags, 5);
+		const u8 *palette = paletteShades[Bit::Get(flags, 4) ? 2 : 1];
+		const u8 tileYLine = (yFlip) ? (spriteHeight - 1 - (line - yPos)) : (line - yPos);
+		const u8 *pixels = GetTileRow(patternNo + (tileYLine / 8), (tileYLine % 8), xFlip);
+
+		for (int pixel = 7; pixel >= 0; pixel--)
 		{
-			for (int pixel = 7; pixel >= 0; pixel--)
-			{
-				const u8 x = (xPos + pixel);
-				const int spritePixel = (xFlip) ? pixel : ((pixel - 7) * -1);
-				const bool isWhite = (screen[LY][x][0] == 155);
-				const u8 colorNum = ((Bit::Get(pixelData2, spritePixel) << 1) | (Bit::Get(pixelData1, spritePixel)));
-				const Rgb pixelColor = GetColor(palette, colorNum);
-
-				// skip drawing off-screen sprites
-				if (x >= 160) continue;
-				// skip drawing transparent pixels
-				if (colorNum == 0x0) continue;
-				// with priority 0x1, if the background pixel isn't white, the sprite isn't drawn
-				if (priority == 0x1 && !isWhite) continue;
-
-				screen[LY][x][0] = pixelColor.r;
-				screen[LY][x][1] = pixelColor.g;
-				screen[LY][x][2] = pixelColor.b;
-			}
+			const u8 x = (xPos + pixel);
+			const u8 colorNum = pixels[pixel];
+
+			// skip drawing off-screen sprites
+			if (x >= 160) continue;
+			// skip drawing transparent pixels
+			if (colorNum == 0x0) continue;
+			// skip pixels a higher priority sprite has already claimed
+			if (covered[x]) continue;
+
+			covered[x] = true;
+
+			// with priority 0x1, the sprite only shows through background colour 0
+			if (priority && backgroundColors[x] != 0x0) continue;
+
+			frameBuffer[line][x] = palette[colorNum];
 		}
 	}
 }
+
+// responsible for saving/loading the lcd state (the caches are rebuilt from memory after a load)
+void Lcd::Serialize(StateBuffer &state)
+{
+	state.Value(scanlineCounter);
+	state.Value(running);
+	state.Bytes(frameBuffer, sizeof(frameBuffer));
+
+	if (!state.loading) return;
+
+	for (int i = 0; i < 3; i++)
+	{
+		paletteValues[i] = -1;
+	}
+
+	FlushTiles();
+	InvalidateOam();
+	screenDirty = true;
+	frameReady = true;
+}
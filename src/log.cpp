@@ -11,6 +11,8 @@
 #include "includes/log.h"
 
 static FILE *logFile;
+// NULL means stdout
+static FILE *output = NULL;
 
 void Log::Init()
 {
@@ -23,22 +25,29 @@ void Log::Close()
 	fclose(logFile);
 }
 
+void Log::Redirect(FILE *stream)
+{
+	output = stream;
+}
+
 void Log::Print(const char *fmt, ...)
 {
+	FILE *stream = (output != NULL) ? output : stdout;
 	va_list args;
 	va_start(args, fmt);
-	vprintf(fmt, args);
-	printf("\n");
+	vfprintf(stream, fmt, args);
+	fprintf(stream, "\n");
 	va_end(args);
 }
 
 void Log::Critical(const char *fmt, ...)
 {
+	FILE *stream = (output != NULL) ? output : stdout;
 	va_list args;
 	va_start(args, fmt);
-	printf("Critical: ");
-	vprintf(fmt, args);
-	printf("\n");
+	fprintf(stream, "Critical: ");
+	vfprintf(stream, fmt, args);
+	fprintf(stream, "\n");
 	va_end(args);
 }
 
@@ -13,16 +13,11 @@
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_sdl.h"
 #include "imgui/imgui_custom_extensions.h"
-#include "includes/bios.h"
 #include "includes/debugger.h"
-#include "includes/cpu.h"
-#include "includes/input.h"
-#include "includes/interrupts.h"
-#include "includes/lcd.h"
+#include "includes/display.h"
+#include "includes/emulationThread.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/memory.h"
-#include "includes/rom.h"
-#include "includes/timer.h"
 #include "tinydir/tinydir.h"
 #include "includes/typedefs.h"
 #include "includes/ui.h"
@@ -31,12 +26,18 @@
 #define SCREEN_WIDTH 640
 #define SCREEN_HEIGHT 480
 #define EMULATOR_NAME "DreamBoy - GameBoy Emulator"
+// the rewind ring keeps a snapshot every REWIND_INTERVAL frames in REWIND_BUFFER_SIZE bytes
+#define REWIND_BUFFER_SIZE (8 * 1024 * 1024)
+#define REWIND_INTERVAL 2
 // vars
 static SDL_Window *window;
 static SDL_GLContext glContext;
 static bool quit = false;
 static bool ctrlPressed = false;
 static int keyPressed = -1;
+static GameBoy *gameBoy = NULL;
+static int hostFrames = 0;
+static Uint64 fpsTimer = 0;
 const char *cpuTests[12] =
 {
 	NULL,
@@ -124,6 +125,7 @@ static void CreateDirectories()
 	if (stat("saves", &st) == -1) mkdir("saves", 0700);
 	if (stat("saves/states", &st) == -1) mkdir("saves/states", 0700);
 	if (stat("saves/states/debugger", &st) == -1) mkdir("saves/states/debugger", 0700);
+	if (stat("saves/movies", &st) == -1) mkdir("saves/movies", 0700);
 }
 
 // responsible for shutting down SDL + misc stuff
@@ -139,7 +141,10 @@ static void Shutdown()
 // responsible for executing operations before the app quits
 static void OnAppQuit()
 {
-	Rom::SaveRam();
+	EmulationThread::Lock();
+	gameBoy->rom.SaveRam();
+	gameBoy->movie.Stop();
+	EmulationThread::Unlock();
 	Debugger::RemoveStates();
 	quit = true;
 }
@@ -147,6 +152,7 @@ static void OnAppQuit()
 // responsible for displaying the various debugger windows
 static void ShowDebugger()
 {
+	if (Debugger::showStats) Debugger::StatsWindow("Stats");
 	if (!Debugger::active) return;
 
 	// show the debugger windows
@@ -154,22 +160,19 @@ static void ShowDebugger()
 	Debugger::MemoryViewerWindow("Program Flow", 180, 230, SCREEN_WIDTH - 180, SCREEN_HEIGHT - 210);
 }
 
-// responsible for the emulation loop
-static void EmulationLoop()
+// responsible for updating the frame rate readouts once a second
+static void UpdateFps()
 {
-	Cpu::cycles = 0;
+	const Uint64 now = SDL_GetPerformanceCounter();
+	const double seconds = ((double)(now - fpsTimer) / SDL_GetPerformanceFrequency());
 
-	while (Cpu::cycles < (MAX_CYCLES / Cpu::framerate))
-	{
-		if (Debugger::stopMachine) break;
-		if (Debugger::stopAtBreakpoint && (Cpu::pc.reg == Debugger::breakpoint))
-		{
-			Debugger::stepThrough = true;
-			break;
-		}
+	hostFrames += 1;
 
-		Cpu::Step();
-	}
+	if (seconds < 1.0) return;
+
+	Ui::SetFps(EmulationThread::TakeFrameCount() / seconds, hostFrames / seconds);
+	hostFrames = 0;
+	fpsTimer = now;
 }
 
 // responsible for the main loop
@@ -179,9 +182,12 @@ static void StartMainLoop()
 
 	while (!quit)
 	{
+		// the machine belongs to the emulation thread, the ui builds its windows from the latest snapshot of it
+		EmulationThread::AcquireSnapshot();
+
 		while (SDL_PollEvent(&event) != 0)
 		{
-			Input::HandleKeys(event);
+			gameBoy->input.HandleKeys(event);
 			ImGui_ImplSdlGL2_ProcessEvent(&event);
 
 			switch(event.type)
@@ -228,67 +234,46 @@ static void StartMainLoop()
 				// hide the menu bar
 				case SDLK_m: Ui::HideMainMenuBar(); break;
 				// save a state
-				case SDLK_s: ctrlPressed = false; Cpu::SaveState(false); break;
+				case SDLK_s: ctrlPressed = false; Ui::SaveState(); break;
 				// load a state
-				case SDLK_l: ctrlPressed = false; Cpu::LoadState(false); break;
+				case SDLK_l: ctrlPressed = false; Ui::LoadState(); break;
 				//  save a screenshot
 				case SDLK_p: ctrlPressed = false; Debugger::SaveScreenshot(); break;
 				// enable/disable the debugger
 				case SDLK_d: ctrlPressed = false; Debugger::active = !Debugger::active; break;
 				// run/stop
 				case SDLK_r:
-					if (!Rom::HasLoaded()) break;
+					if (!EmulationThread::GetSnapshot().romLoaded) break;
 
 					ctrlPressed = false;
-					Debugger::stepThrough = false;
-					Debugger::stopAtBreakpoint = false;
+					EmulationThread::SendCommand(EmulationThread::ResumeNoBreak);
 					Ui::HideMainMenuBar();
 				break;
 				// open the select rom popup
-				case SDLK_o: ctrlPressed = false; Rom::Select(); break;
+				case SDLK_o: ctrlPressed = false; Ui::SelectRom(); break;
 				// close the rom
-				case SDLK_c: ctrlPressed = false; Debugger::ResetSystem(); break;
+				case SDLK_c: ctrlPressed = false; EmulationThread::SendCommand(EmulationThread::Reset); break;
 				// step forward
-				case SDLK_f:
-					ctrlPressed = false;
-
-					if (Debugger::stepThrough)
-					{
-						Cpu::Step();
-						Cpu::SaveState(true, Cpu::instructionsRan);
-					}
-				break;
+				case SDLK_f: ctrlPressed = false; EmulationThread::SendCommand(EmulationThread::StepForward); break;
 				// step backward
-				case SDLK_b:
-					ctrlPressed = false;
-
-					if (Debugger::stepThrough)
-					{
-						if (Cpu::instructionsRan > 0)
-						{
-							Cpu::LoadState(true, Cpu::instructionsRan);
-							Cpu::instructionsRan -= 1;
-						}
-						else
-						{
-							Debugger::ResetSystem();
-						}
-					}
-				break;
+				case SDLK_b: ctrlPressed = false; EmulationThread::SendCommand(EmulationThread::StepBackward); break;
 			}
 		}
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		ImGui_ImplSdlGL2_NewFrame(window);
 
-		if (!Debugger::stepThrough) EmulationLoop();
-
-		Lcd::Render();
 		ShowDebugger();
 		Ui::Render();
+
+		const u8 *frame = EmulationThread::AcquireFrame();
+		if (frame != NULL) Display::UpdateTexture(frame);
+
+		Display::Render();
 		ImGui::Render();
 
 		SDL_GL_SwapWindow(window);
+		UpdateFps();
 	}
 }
 
@@ -298,19 +283,20 @@ int main(int argc, char *argv[])
 	{
 		CreateDirectories();
 		Log::Init();
-		Memory::Init();
-		//Rom::Load(cpuTests[2]);
-
-		//Cpu::didLoadBios = Bios::Load("bios.bin");
-		Interrupts::Init();
-		Cpu::Init();
-		Timer::Init();
-		Lcd::Init();
-		Input::Init();
+		gameBoy = new GameBoy();
+		gameBoy->rewind.Enable(REWIND_BUFFER_SIZE, REWIND_INTERVAL);
+		//gameBoy->LoadRom(cpuTests[2], "bios.bin");
+
+		Debugger::Init(gameBoy);
+		Ui::Init(gameBoy);
+		Display::Init();
+		EmulationThread::Start(gameBoy);
 		StartMainLoop();
+		EmulationThread::Shutdown();
 	}
 
 	Shutdown();
+	delete gameBoy;
 
 	return 0;
 }
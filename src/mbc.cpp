@@ -8,14 +8,11 @@
  */
 
 // includes
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/mbc.h"
-#include "includes/mbc1.h"
 //#include "includes/mbc2.h"
 //#include "includes/mbc3.h"
 //#include "includes/mbc5.h"
-#include "includes/memory.h"
-#include "includes/rom.h"
 
 // definitions
 #define MBC1 0x1 ... 0x3
@@ -30,35 +27,47 @@ const u16 Mbc::maxSize[0x9] =
 	[0x6] = 0x80, [0x7] = 0x100, [0x8] = 0x200
 };
 
+// responsible for constructing the memory bank controller
+Mbc::Mbc(GameBoy &gb) : gb(gb), mbc1(gb)
+{
+
+}
+
 // responsible for returning the rom banks maximum size
 u16 Mbc::GetMaxBankSize()
 {
-	return (maxSize[Rom::romSize] - 0x1);
+	return (maxSize[gb.rom.romSize] - 0x1);
 }
 
 // responsible for managing rom banking
 void Mbc::RomBanking(u16 address, u8 data)
 {
-	switch(Rom::mbcType)
+	STATS(const u16 romBank = gb.rom.romBank; const u8 ramBank = gb.rom.ramBank);
+
+	switch(gb.rom.mbcType)
 	{
-		case MBC1: Mbc1::RomBanking(address, data); break;
+		case MBC1: mbc1.RomBanking(address, data); break;
 		//case MBC2: Mbc2::RomBanking(address, data); break;
 		//case MBC3: Mbc3::RomBanking(address, data); break;
 		//case MBC5: Mbc5::RomBanking(address, data); break;
 		default: break;
 	}
+
+	STATS(gb.stats.CountBanking(romBank, ramBank));
 }
 
 // responsible for managing banking
 void Mbc::ManageBanking(u16 address, u8 data)
 {
+	STATS(const u16 romBank = gb.rom.romBank; const u8 ramBank = gb.rom.ramBank);
+
 	switch(address)
 	{
 		// handle selecting ram bank/upper two bits of rom bank
 		case 0x4000 ... 0x5FFF:
-			switch(Rom::mbcType)
+			switch(gb.rom.mbcType)
 			{
-				case MBC1: Mbc1::ManageSelection(data); break;
+				case MBC1: mbc1.ManageSelection(data); break;
 				//case MBC2: Mbc2::ManageSelection(data); break;
 				//case MBC3: Mbc3::ManageSelection(data); break;
 				//case MBC5: Mbc5::ManageSelection(data); break;
@@ -68,9 +77,9 @@ void Mbc::ManageBanking(u16 address, u8 data)
 
 		// handle rom/ram mode
 		case 0x6000 ... 0x7FFF:
-			switch(Rom::mbcType)
+			switch(gb.rom.mbcType)
 			{
-				case MBC1: Mbc1::ManageMode(data); break;
+				case MBC1: mbc1.ManageMode(data); break;
 				//case MBC2: Mbc2::ManageMode(data); break;
 				//case MBC3: Mbc3::ManageMode(data); break;
 				//case MBC5: Mbc5::ManageMode(data); break;
@@ -78,5 +87,7 @@ void Mbc::ManageBanking(u16 address, u8 data)
 			}
 		break;
 	}
+
+	STATS(gb.stats.CountBanking(romBank, ramBank));
 }
 
@@ -9,11 +9,14 @@
 
 // includes
 #include "includes/bit.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/mbc.h"
-#include "includes/mbc1.h"
-#include "includes/memory.h"
-#include "includes/rom.h"
+
+// responsible for constructing the MBC1 controller
+Mbc1::Mbc1(GameBoy &gb) : gb(gb)
+{
+
+}
 
 // responsible for managing MBC1 rom banking
 void Mbc1::RomBanking(u16 address, u8 data)
@@ -25,29 +28,29 @@ void Mbc1::RomBanking(u16 address, u8 data)
 		bankNo += 0x1;
 	}
 
-	Rom::romBank = bankNo;
+	gb.rom.romBank = bankNo;
 }
 
 // responsible for managing the bank selection(s)
 void Mbc1::ManageSelection(u8 data)
 {
 	// 0 = 16/8 mode || 1 = 4/32 mode
-	if (Rom::currentMode == 0x0)
+	if (gb.rom.currentMode == 0x0)
 	{
-		const u8 romBankMask = Mbc::GetMaxBankSize();
-		Rom::romBank &= romBankMask;
-		Rom::romBank |= (((data & 0x3) << 5) & romBankMask);
+		const u8 romBankMask = gb.mbc.GetMaxBankSize();
+		gb.rom.romBank &= romBankMask;
+		gb.rom.romBank |= (((data & 0x3) << 5) & romBankMask);
 	}
 	else
 	{
 		// only ram sizes 0x3 and 0x4 have more than one ram bank
-		if (Rom::ramSize > 0x2) Rom::ramBank = (data & 0x3);
+		if (gb.rom.ramSize > 0x2) gb.rom.ramBank = (data & 0x3);
 	}
 }
 
 // responsible for managing the bank mode(s)
 void Mbc1::ManageMode(u8 data)
 {
-	Rom::currentMode = (data & 0x1);
-	Memory::useRomBank = (Rom::currentMode == 0x0);
+	gb.rom.currentMode = (data & 0x1);
+	gb.memory.useRomBank = (gb.rom.currentMode == 0x0);
 }
@@ -9,9 +9,14 @@
 
 // includes
 #include "includes/mbc2.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/memory.h"
-#include "includes/rom.h"
+
+// responsible for constructing the MBC2 controller
+Mbc2::Mbc2(GameBoy &gb) : gb(gb)
+{
+
+}
 
 // responsible for managing MBC2 rom banking
 void Mbc2::RomBanking(u16 address, u8 data)
@@ -9,9 +9,14 @@
 
 // includes
 #include "includes/mbc3.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/memory.h"
-#include "includes/rom.h"
+
+// responsible for constructing the MBC3 controller
+Mbc3::Mbc3(GameBoy &gb) : gb(gb)
+{
+
+}
 
 // responsible for managing MBC3 rom banking
 void Mbc3::RomBanking(u16 address, u8 data)
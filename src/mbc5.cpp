@@ -9,10 +9,15 @@
 
 // includes
 #include "includes/bit.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
 #include "includes/mbc5.h"
-#include "includes/memory.h"
-#include "includes/rom.h"
+
+// responsible for constructing the MBC5 controller
+Mbc5::Mbc5(GameBoy &gb) : gb(gb)
+{
+
+}
 
 // responsible for managing MBC5 rom banking
 void Mbc5::RomBanking(u16 address, u8 data)
@@ -9,19 +9,25 @@
 
 // includes
 #include "includes/bit.h"
-#include "includes/input.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/mbc.h"
-#include "includes/memory.h"
-#include "includes/rom.h"
+#include "includes/profiler.h"
 
-// init vars
-u8 Memory::mem[0x10000] = {0x00};
-bool Memory::useRomBank = true;
-bool Memory::useRamBank = false;
+// responsible for constructing the memory
+Memory::Memory(GameBoy &gb) :
+	mem(),
+	useRomBank(true),
+	useRamBank(false),
+	serialOutput(stdout),
+	gb(gb),
+	readPages(),
+	writePages()
+{
+
+}
 
 // responsible for initializing the memory
-void Memory:: Init()
+void Memory::Init()
 {
 	useRomBank = true;
 	useRamBank = false;
@@ -62,29 +68,98 @@ void Memory:: Init()
 	mem[Address::NR50] = 0x77;
 	mem[Address::NR51] = 0xF3;
 	mem[Address::NR52] = 0xF1;
+
+	MapPages();
+}
+
+// responsible for rebuilding the page table (whenever the rom/ram banking changes)
+void Memory::MapPages()
+{
+	for (int i = 0; i < 0x100; i++)
+	{
+		readPages[i] = &mem[i << 8];
+		writePages[i] = NULL;
+	}
+
+	// switchable rom bank (the legacy banking mode is left to ReadByte if the header size is unknown)
+	const u8 *romBank = &gb.rom.rom[(gb.rom.romBank & gb.rom.romBankMask) * 0x4000];
+
+	if (!useRomBank) romBank = (gb.rom.romSize <= 0x8) ? &gb.rom.rom[(gb.rom.romBank & gb.mbc.GetMaxBankSize()) * 0x4000] : NULL;
+
+	for (int i = 0x40; i < 0x80; i++)
+	{
+		readPages[i] = (romBank != NULL) ? &romBank[(i - 0x40) << 8] : NULL;
+	}
+
+	// external ram (disabled ram is left to ReadByte/WriteByte)
+	const u8 ramBank = (gb.rom.currentMode == 0x0) ? 0x0 : gb.rom.ramBank;
+
+	for (int i = 0xA0; i < 0xC0; i++)
+	{
+		u8 *page = (useRamBank) ? &gb.rom.ram[(ramBank * 0x2000) + ((i - 0xA0) << 8)] : NULL;
+		readPages[i] = page;
+		writePages[i] = page;
+	}
+
+	// the vram tile maps and the end of work ram (which isn't echoed) can be written straight to
+	for (int i = 0x98; i < 0xA0; i++) writePages[i] = &mem[i << 8];
+	for (int i = 0xDE; i < 0xE0; i++) writePages[i] = &mem[i << 8];
+
+	// oam/protected memory and the io registers/hram have special cases
+	readPages[0xFE] = NULL;
+	readPages[0xFF] = NULL;
+
+	gb.blockCache.Remap();
+}
+
+// responsible for copying the memory map as the cpu currently sees it, without the side effects of ReadByte (ie. for the debugger)
+void Memory::CopyMap(u8 *out)
+{
+	for (int i = 0; i < 0x100; i++)
+	{
+		const u8 *page = (readPages[i] != NULL) ? readPages[i] : &mem[i << 8];
+		memcpy(&out[i << 8], page, 0x100);
+	}
 }
 
 // responsible for reading a byte from a specific memory location
 u8 Memory::ReadByte(u16 address)
 {
+	PROFILE_SECTION(Profiler::MEMORY);
+	STATS(gb.stats.CountRead(address));
+
+	const u8 *page = readPages[address >> 8];
+
+	if (page != NULL) return page[address & 0xFF];
+
+	return PeekByte(address);
+}
+
+// responsible for reading a byte without counting it in the stats (ie. opcode fetches and the emulator's own reads)
+u8 Memory::PeekByte(u16 address)
+{
+	const u8 *page = readPages[address >> 8];
+
+	if (page != NULL) return page[address & 0xFF];
+
 	switch(address)
 	{
 		case Address::ROM_BK1_START ... Address::ROM_BK1_END:
 		{
-			int bankAddr = ((Rom::romBank * 0x4000) + (address - 0x4000));
-			if (!useRomBank) bankAddr = (((Rom::romBank & Mbc::GetMaxBankSize()) * 0x4000) + (address - 0x4000));
-			return Rom::rom[bankAddr];
+			int bankAddr = (((gb.rom.romBank & gb.rom.romBankMask) * 0x4000) + (address - 0x4000));
+			if (!useRomBank) bankAddr = (((gb.rom.romBank & gb.mbc.GetMaxBankSize()) * 0x4000) + (address - 0x4000));
+			return gb.rom.rom[bankAddr];
 		}
 		break;
 		case Address::EXTRAM_START ... Address::EXTRAM_END:
 			if (useRamBank)
 			{
-				const u8 ramBank = (Rom::currentMode == 0x0) ? 0x0 : Rom::ramBank;
-				return Rom::ram[(ramBank * 0x2000) + (address - Address::EXTRAM_START)];
+				const u8 ramBank = (gb.rom.currentMode == 0x0) ? 0x0 : gb.rom.ramBank;
+				return gb.rom.ram[(ramBank * 0x2000) + (address - Address::EXTRAM_START)];
 			}
 			else return 0xFF;
 		break;
-		case Address::P1: return Input::GetKey(mem[address]); break;
+		case Address::P1: return gb.input.GetKey(mem[address]); break;
 		case Address::PROT_MEM_START ... Address::PROT_MEM_END: return 0xFF; break;
 		case Address::NR10: return 0xFF; break;
 		case Address::NR11: return 0xFF; break;
@@ -111,12 +186,26 @@ u8 Memory::ReadByte(u16 address)
 
 // responsible for reading a word from a specific memory location
 u16 Memory::ReadWord(u16 address)
+{
+	PROFILE_SECTION(Profiler::MEMORY);
+	STATS(gb.stats.CountRead(address); gb.stats.CountRead(address + 1));
+
+	return PeekWord(address);
+}
+
+// responsible for reading a word without counting it in the stats
+u16 Memory::PeekWord(u16 address)
 {
 	if (address >= Address::ROM_BK1_START && address <= Address::ROM_BK1_END)
 	{
-		int bankAddr = ((Rom::romBank * 0x4000) + (address - 0x4000));
-		if (!useRomBank) bankAddr = (((Rom::romBank & Mbc::GetMaxBankSize()) * 0x4000) + (address - 0x4000));
-		return ((Rom::rom[bankAddr + 1] << 8) | (Rom::rom[bankAddr]));
+		const u8 *page = readPages[address >> 8];
+
+		// the bank is contiguous, so the high byte can run on past the end of the page
+		if (page != NULL) return ((page[(address & 0xFF) + 1] << 8) | (page[address & 0xFF]));
+
+		int bankAddr = (((gb.rom.romBank & gb.rom.romBankMask) * 0x4000) + (address - 0x4000));
+		if (!useRomBank) bankAddr = (((gb.rom.romBank & gb.mbc.GetMaxBankSize()) * 0x4000) + (address - 0x4000));
+		return ((gb.rom.rom[bankAddr + 1] << 8) | (gb.rom.rom[bankAddr]));
 	}
 
 	return ((mem[address + 1] << 8) | (mem[address]));
@@ -125,6 +214,17 @@ u16 Memory::ReadWord(u16 address)
 // responsible for writing a byte to a specific memory location
 void Memory::WriteByte(u16 address, u8 data)
 {
+	PROFILE_SECTION(Profiler::MEMORY);
+	STATS(gb.stats.CountWrite(address));
+
+	u8 *page = writePages[address >> 8];
+
+	if (page != NULL)
+	{
+		page[address & 0xFF] = data;
+		return;
+	}
+
 	switch (address)
 	{
 		// disable writes to protected memory
@@ -140,53 +240,77 @@ void Memory::WriteByte(u16 address, u8 data)
 
 			for (u16 i = 0; i < 0xA0; i++)
 			{
-				mem[0xFE00 + i] = ReadByte(addr + i);
+				mem[0xFE00 + i] = PeekByte(addr + i);
 			}
+
+			gb.lcd.InvalidateOam();
 		}
 		break;
 
+		// let the timer and lcd catch up before their control registers change
+		case Address::TAC:
+		case Address::LCDC:
+		case Address::STAT:
+			gb.scheduler.Sync();
+			mem[address] = data;
+		break;
+
 		// reset DIV if it is written to
 		case Address::DIV: mem[address] = 0x00; break;
 
 		// read from the serial port (useful for blarggs cpu tests)
 		case Address::SERIAL_CTRL:
-			if (data == 0x81) printf("%c", ReadByte(Address::SERIAL));
+			if (data == 0x81 && serialOutput != NULL) fputc(PeekByte(Address::SERIAL), serialOutput);
+			mem[address] = data;
+		break;
+
+		// let the lcd know its decoded copy of a tile is out of date
+		case Address::TILE_DATA_START ... Address::TILE_DATA_END:
 			mem[address] = data;
+			gb.lcd.InvalidateTile(address);
+		break;
+
+		// let the lcd know its sprite index is out of date
+		case Address::OAM_START ... Address::OAM_END:
+			mem[address] = data;
+			gb.lcd.InvalidateOam();
 		break;
 
 		// if writing to work ram, write to echo ram
 		case Address::WRAM_START ... Address::WRAM_END:
 			mem[address] = data;
 			mem[address + 0x2000] = data;
+			gb.blockCache.Invalidate(address);
 		break;
 
 		// if writing to echo ram, write to work ram
 		case Address::ERAM_START ... Address::ERAM_END:
 			mem[address] = data;
 			mem[address - 0x2000] = data;
+			gb.blockCache.Invalidate(address - 0x2000);
 		break;
 
 		// if writing specific data to unmapped memory
 		case Address::UNMAPPED_START ... Address::UNMAPPED_END:
 			// copy rom back over bios
-			if (data == 0x1) Rom::Reload();
+			if (data == 0x1) gb.rom.Reload();
 		break;
 
 		// handle enabling ram banking
-		case 0x0000 ... 0x1FFF: useRamBank = ((data & 0xF) == 0xA) ? true : false; break;
+		case 0x0000 ... 0x1FFF: useRamBank = ((data & 0xF) == 0xA) ? true : false; MapPages(); break;
 
 		// rom banking
-		case 0x2000 ... 0x3FFF: Mbc::RomBanking(address, data); break;
+		case 0x2000 ... 0x3FFF: gb.mbc.RomBanking(address, data); MapPages(); break;
 
 		// manage rom banking
-		case 0x4000 ... 0x7FFF: Mbc::ManageBanking(address, data); break;
+		case 0x4000 ... 0x7FFF: gb.mbc.ManageBanking(address, data); MapPages(); break;
 
 		// handle external ram
 		case Address::EXTRAM_START ... Address::EXTRAM_END:
 			if (useRamBank)
 			{
-				const u8 ramBank = (Rom::currentMode == 0x0) ? 0x0 : Rom::ramBank;
-				Rom::ram[(ramBank * 0x2000) + (address - Address::EXTRAM_START)] = data;
+				const u8 ramBank = (gb.rom.currentMode == 0x0) ? 0x0 : gb.rom.ramBank;
+				gb.rom.ram[(ramBank * 0x2000) + (address - Address::EXTRAM_START)] = data;
 			}
 		break;
 
@@ -198,15 +322,19 @@ void Memory::WriteByte(u16 address, u8 data)
 // responsible for writing a word to a specific memory location
 void Memory::WriteWord(u16 address, Cpu::Register reg)
 {
+	STATS(gb.stats.CountWrite(address); gb.stats.CountWrite(address + 1));
+
 	mem[address] = reg.lo;
 	mem[address + 1] = reg.hi;
+	InvalidateCaches(address);
+	InvalidateCaches(address + 1);
 }
 
 // responsible for popping a u16 from the stack
 u16 Memory::Pop()
 {
-	const u16 data = ReadWord(Cpu::sp.reg);
-	Cpu::sp.reg += 2;
+	const u16 data = ReadWord(gb.cpu.sp.reg);
+	gb.cpu.sp.reg += 2;
 
 	return data;
 }
@@ -214,8 +342,28 @@ u16 Memory::Pop()
 // responsible for pushing a u16 to the stack
 void Memory::Push(Cpu::Register reg)
 {
-	Cpu::sp.reg -= 1;
-	mem[Cpu::sp.reg] = reg.hi;
-	Cpu::sp.reg -= 1;
-	mem[Cpu::sp.reg] = reg.lo;
+	STATS(gb.stats.CountWrite(gb.cpu.sp.reg - 1); gb.stats.CountWrite(gb.cpu.sp.reg - 2));
+
+	gb.cpu.sp.reg -= 1;
+	mem[gb.cpu.sp.reg] = reg.hi;
+	InvalidateCaches(gb.cpu.sp.reg);
+	gb.cpu.sp.reg -= 1;
+	mem[gb.cpu.sp.reg] = reg.lo;
+	InvalidateCaches(gb.cpu.sp.reg);
+}
+
+// responsible for dropping any cached code or tiles at an address written to without going through WriteByte
+void Memory::InvalidateCaches(u16 address)
+{
+	if (address >= Address::WRAM_START && address <= Address::WRAM_END) gb.blockCache.Invalidate(address);
+	else if (address >= Address::TILE_DATA_START && address <= Address::TILE_DATA_END) gb.lcd.InvalidateTile(address);
+	else if (address >= Address::OAM_START && address <= Address::OAM_END) gb.lcd.InvalidateOam();
+}
+
+// responsible for saving/loading the memory state
+void Memory::Serialize(StateBuffer &state)
+{
+	state.Bytes(mem, sizeof(mem));
+	state.Value(useRomBank);
+	state.Value(useRamBank);
 }
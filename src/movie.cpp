@@ -0,0 +1,298 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include "includes/gameboy.h"
+#include "includes/log.h"
+#include "includes/movie.h"
+
+// definitions
+// a day of play, so a corrupt frame count can't ask for gigabytes
+#define MOVIE_MAX_FRAMES (60 * 60 * 60 * 24)
+#define MOVIE_MAX_EVENTS MOVIE_MAX_FRAMES
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+// responsible for hashing a block of memory (FNV-1a)
+static unsigned int Hash(unsigned int hash, const u8 *data, size_t length)
+{
+	for (size_t i = 0; i < length; i++)
+	{
+		hash = ((hash ^ data[i]) * FNV_PRIME);
+	}
+
+	return hash;
+}
+
+// responsible for constructing the movie
+Movie::Movie(GameBoy &gb) : frame(0), divergedFrame(-1), gb(gb), recording(false), playing(false), flags(0), nextEvent(0)
+{
+
+}
+
+// responsible for starting a recording from the machine's current state
+bool Movie::Record(const char *filePath)
+{
+	Stop();
+
+	if (!gb.rom.HasLoaded()) return false;
+
+	startState.resize(gb.StateSize());
+	gb.SaveState(&startState[0], startState.size());
+
+	frames.clear();
+	keyEvents.clear();
+	nextEvent = 0;
+	path = filePath;
+	flags = (ScreenHashed()) ? MOVIE_SCREEN_HASHED : 0;
+	frame = 0;
+	divergedFrame = -1;
+	recording = true;
+
+	return true;
+}
+
+// responsible for loading a movie and putting the machine back in the state it was recorded from
+bool Movie::Play(const char *filePath)
+{
+	Stop();
+
+	FILE *fp = fopen(filePath, "rb");
+
+	if (fp == NULL)
+	{
+		Log::Critical("Failed to open movie: '%s'", filePath);
+		return false;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	const long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	std::vector<u8> data((size > 0) ? size : 1);
+	const size_t read = fread(&data[0], 1, data.size(), fp);
+	fclose(fp);
+
+	// the movie is only taken on once the machine has loaded its starting state
+	StateBuffer state((const u8 *)&data[0], read);
+	Movie loaded(gb);
+
+	if (!loaded.Serialize(state) || state.Failed())
+	{
+		Log::Critical("Invalid movie: '%s'", filePath);
+		return false;
+	}
+
+	if (!gb.LoadState(&loaded.startState[0], loaded.startState.size()))
+	{
+		Log::Critical("Movie '%s' wasn't recorded with this rom", filePath);
+		return false;
+	}
+
+	startState.swap(loaded.startState);
+	frames.swap(loaded.frames);
+	keyEvents.swap(loaded.keyEvents);
+	nextEvent = 0;
+	flags = loaded.flags;
+	path = filePath;
+	frame = 0;
+	divergedFrame = -1;
+	playing = !frames.empty();
+
+	return true;
+}
+
+// responsible for ending the recording/replay (a recording gets written out)
+void Movie::Stop()
+{
+	if (recording)
+	{
+		// drop a frame that was started but never finished, and the keys that were waiting on one
+		frames.resize(frame);
+
+		while (!keyEvents.empty() && keyEvents.back().frame >= (unsigned int)frame) keyEvents.pop_back();
+
+		StateBuffer measure((u8 *)NULL, 0);
+		Serialize(measure);
+
+		std::vector<u8> data(measure.Offset());
+		StateBuffer state(&data[0], data.size());
+		Serialize(state);
+
+		FILE *fp = fopen(path.c_str(), "wb");
+
+		if (fp != NULL)
+		{
+			fwrite(&data[0], 1, data.size(), fp);
+			fclose(fp);
+			Log::Print("Saved movie of %d frames to: %s", frame, path.c_str());
+		}
+		else
+		{
+			Log::Critical("Failed to save movie to: '%s'", path.c_str());
+		}
+	}
+
+	recording = false;
+	playing = false;
+}
+
+// responsible for starting a frame, applying the key changes that came before it when playing
+void Movie::BeginFrame()
+{
+	if (playing)
+	{
+		while (nextEvent < keyEvents.size() && keyEvents[nextEvent].frame <= (unsigned int)frame)
+		{
+			const KeyEvent &event = keyEvents[nextEvent++];
+			gb.input.SetKey(event.key, (event.pressed != 0));
+		}
+	}
+	else if (recording)
+	{
+		// breakpoints are off while recording, so a frame always runs to the end once it has started
+		if ((int)frames.size() == frame) frames.push_back(Frame());
+	}
+}
+
+// responsible for recording a key change, to be applied before the next frame when played
+void Movie::RecordKey(u8 key, bool pressed)
+{
+	if (!recording) return;
+
+	KeyEvent event = {(unsigned int)frame, key, (u8)pressed};
+	keyEvents.push_back(event);
+}
+
+// responsible for recording/checking the hashes once a frame has run
+void Movie::EndFrame()
+{
+	if (recording)
+	{
+		if (!ScreenHashed()) flags &= ~MOVIE_SCREEN_HASHED;
+
+		frames[frame].ramHash = HashRam();
+		frames[frame].screenHash = HashScreen();
+		frame += 1;
+	}
+	else if (playing)
+	{
+		const Frame &recorded = frames[frame];
+		const bool checkScreen = ((flags & MOVIE_SCREEN_HASHED) && ScreenHashed());
+		const bool matched = (recorded.ramHash == HashRam() && (!checkScreen || recorded.screenHash == HashScreen()));
+
+		if (!matched && divergedFrame < 0)
+		{
+			divergedFrame = frame;
+			Log::Critical("Movie diverged from the recording at frame %d", frame);
+		}
+
+		frame += 1;
+
+		if (frame >= (int)frames.size())
+		{
+			playing = false;
+			Log::Print("Movie finished after %d frames (%s)", frame, (divergedFrame < 0) ? "matched the recording" : "diverged");
+		}
+	}
+}
+
+// responsible for returning whether a recording is running
+bool Movie::IsRecording()
+{
+	return recording;
+}
+
+// responsible for returning whether a replay is running
+bool Movie::IsPlaying()
+{
+	return playing;
+}
+
+// responsible for returning how many frames the movie holds
+int Movie::FrameCount()
+{
+	return (int)frames.size();
+}
+
+// responsible for saving/loading the movie (returns false if it isn't a movie this build can play)
+bool Movie::Serialize(StateBuffer &state)
+{
+	char magic[4];
+	u16 version = MOVIE_VERSION;
+	unsigned int stateSize = (unsigned int)startState.size();
+	unsigned int frameCount = (unsigned int)frames.size();
+	unsigned int eventCount = (unsigned int)keyEvents.size();
+
+	memcpy(magic, MOVIE_MAGIC, sizeof(magic));
+
+	state.Bytes(magic, sizeof(magic));
+	state.Value(version);
+	state.Value(flags);
+	state.Value(stateSize);
+	state.Value(frameCount);
+	state.Value(eventCount);
+
+	if (state.loading)
+	{
+		if (state.Failed() || memcmp(magic, MOVIE_MAGIC, sizeof(magic)) != 0 || version != MOVIE_VERSION) return false;
+		if (stateSize != gb.StateSize() || frameCount > MOVIE_MAX_FRAMES || eventCount > MOVIE_MAX_EVENTS) return false;
+
+		startState.resize(stateSize);
+		frames.resize(frameCount);
+		keyEvents.resize(eventCount);
+	}
+
+	state.Bytes(&startState[0], startState.size());
+
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		state.Value(frames[i].ramHash);
+		state.Value(frames[i].screenHash);
+	}
+
+	for (size_t i = 0; i < keyEvents.size(); i++)
+	{
+		state.Value(keyEvents[i].frame);
+		state.Value(keyEvents[i].key);
+		state.Value(keyEvents[i].pressed);
+
+		// the events are played back in order, so one out of order (or for a key/frame that doesn't exist) means the movie is corrupt
+		if (!state.loading) continue;
+		if (keyEvents[i].key > BTN_START || keyEvents[i].frame >= frameCount) return false;
+		if (i > 0 && keyEvents[i].frame < keyEvents[i - 1].frame) return false;
+	}
+
+	return true;
+}
+
+// responsible for returning whether every frame is being drawn in full
+bool Movie::ScreenHashed()
+{
+	return (gb.lcd.renderEnabled && gb.lcd.frameSkip == 0);
+}
+
+// responsible for hashing vram, work ram, oam and high ram
+unsigned int Movie::HashRam()
+{
+	unsigned int hash = FNV_OFFSET;
+
+	hash = Hash(hash, &gb.memory.mem[0x8000], 0x2000);
+	hash = Hash(hash, &gb.memory.mem[0xC000], 0x2000);
+	hash = Hash(hash, &gb.memory.mem[0xFE00], 0xA0);
+	hash = Hash(hash, &gb.memory.mem[0xFF80], 0x7F);
+
+	return hash;
+}
+
+// responsible for hashing the frame buffer
+unsigned int Movie::HashScreen()
+{
+	return Hash(FNV_OFFSET, gb.lcd.GetFrameBuffer(), (144 * 160));
+}
@@ -0,0 +1,102 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include <signal.h>
+#include <sys/time.h>
+#include "includes/profiler.h"
+
+// definitions
+// how much cpu time passes between samples (the kernel may round this up to its tick)
+#define PROFILER_INTERVAL_US 100
+
+// init vars
+volatile int Profiler::current = Profiler::OTHER;
+volatile long long Profiler::samples[Profiler::SECTION_COUNT] = {0};
+static const char *sectionNames[Profiler::SECTION_COUNT] = {"other", "cpu", "memory", "lcd", "lcd_draw", "timer"};
+
+// responsible for returning whether the sections were compiled in
+bool Profiler::Available()
+{
+	#ifdef PROFILE_SECTIONS
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+// responsible for starting the sampling timer (returns false if the sections weren't compiled in)
+bool Profiler::Start()
+{
+	if (!Available()) return false;
+
+	struct sigaction action = {};
+	action.sa_handler = &Profiler::OnSample;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+
+	if (sigaction(SIGPROF, &action, NULL) != 0) return false;
+
+	struct itimerval timer = {};
+	timer.it_interval.tv_usec = PROFILER_INTERVAL_US;
+	timer.it_value.tv_usec = PROFILER_INTERVAL_US;
+
+	return (setitimer(ITIMER_PROF, &timer, NULL) == 0);
+}
+
+// responsible for stopping the sampling timer
+void Profiler::Stop()
+{
+	struct itimerval timer = {};
+
+	setitimer(ITIMER_PROF, &timer, NULL);
+	signal(SIGPROF, SIG_IGN);
+}
+
+// responsible for clearing the samples
+void Profiler::Reset()
+{
+	for (int i = 0; i < SECTION_COUNT; i++)
+	{
+		samples[i] = 0;
+	}
+}
+
+// responsible for returning how many samples landed in a section
+long long Profiler::Samples(int section)
+{
+	return samples[section];
+}
+
+// responsible for returning how many samples were taken
+long long Profiler::TotalSamples()
+{
+	long long total = 0;
+
+	for (int i = 0; i < SECTION_COUNT; i++)
+	{
+		total += samples[i];
+	}
+
+	return total;
+}
+
+// responsible for returning the name of a section
+const char *Profiler::Name(int section)
+{
+	return sectionNames[section];
+}
+
+// responsible for counting a sample against the section that was running
+void Profiler::OnSample(int signal)
+{
+	const int section = current;
+
+	if (section >= 0 && section < SECTION_COUNT) samples[section] += 1;
+}
@@ -0,0 +1,341 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include "includes/gameboy.h"
+#include "includes/rewind.h"
+
+// definitions
+// a literal run only ends once this many bytes in a row are unchanged, so sparse changes don't cost a token each
+#define REWIND_MIN_SKIP 4
+#define REWIND_MAX_RUN 0xFFFF
+
+// responsible for constructing the rewind buffer
+Rewind::Rewind(GameBoy &gb) : enabled(false), interval(1), gb(gb), latestCycles(0), ringHead(0), framesSinceCapture(0), replayStats(gb)
+{
+
+}
+
+// responsible for allocating the ring and starting to take snapshots
+void Rewind::Enable(size_t bufferSize, int interval)
+{
+	ring.assign(bufferSize, 0);
+	this->interval = (interval > 0) ? interval : 1;
+	enabled = true;
+	Clear();
+}
+
+// responsible for stopping snapshots and freeing the ring
+void Rewind::Disable()
+{
+	enabled = false;
+	Clear();
+	std::vector<u8>().swap(ring);
+	std::vector<u8>().swap(latest);
+	std::vector<u8>().swap(scratch);
+	std::vector<u8>().swap(encoded);
+}
+
+// responsible for forgetting every snapshot (ie. when the machine is reset or a state is loaded)
+void Rewind::Clear()
+{
+	latest.clear();
+	deltas.clear();
+	latestCycles = 0;
+	ringHead = 0;
+	framesSinceCapture = 0;
+}
+
+// responsible for counting frames and taking a snapshot every interval frames
+void Rewind::OnFrame()
+{
+	if (!enabled) return;
+
+	framesSinceCapture += 1;
+
+	if (framesSinceCapture >= interval) Capture();
+}
+
+// responsible for taking a snapshot of the machine, turning the previous one into a delta
+void Rewind::Capture()
+{
+	if (!enabled) return;
+
+	const size_t size = gb.StateSize();
+
+	scratch.resize(size);
+	gb.SaveState(&scratch[0], size);
+
+	if (latest.size() == size) Push(latestCycles);
+	else deltas.clear();
+
+	latest.swap(scratch);
+	latestCycles = gb.cpu.totalCycles;
+	framesSinceCapture = 0;
+}
+
+// responsible for returning whether there's a snapshot to go back to
+bool Rewind::HasSnapshot()
+{
+	return !latest.empty();
+}
+
+// responsible for returning how many snapshots are held
+size_t Rewind::Count()
+{
+	return (latest.empty()) ? 0 : (deltas.size() + 1);
+}
+
+// responsible for returning how much memory the snapshots take up
+size_t Rewind::BytesUsed()
+{
+	size_t bytes = latest.size();
+
+	for (size_t i = 0; i < deltas.size(); i++)
+	{
+		bytes += deltas[i].length;
+	}
+
+	return bytes;
+}
+
+// responsible for going back to the previous snapshot (the newest one, if frames have run since it was taken)
+bool Rewind::StepBack()
+{
+	if (latest.empty()) return false;
+
+	if (framesSinceCapture == 0)
+	{
+		if (deltas.empty()) return false;
+
+		Pop();
+	}
+
+	gb.LoadState(&latest[0], latest.size());
+	framesSinceCapture = 0;
+
+	// keys still held now were pressed after the snapshot, so press them again (and snapshot that on top, so a replay never runs across it)
+	if (gb.input.HoldKeys()) Capture();
+
+	return true;
+}
+
+// responsible for getting the machine ready to run steps again that it has already run
+void Rewind::BeginReplay(Replay &replay)
+{
+	// replay an instruction at a time, as skipping a polling loop's iterations (or fusing a pair of opcodes) would step back over all of them at once
+	replay.idleLoops = gb.blockCache.idleLoops;
+	replay.fuseOps = gb.blockCache.fuseOps;
+	gb.blockCache.idleLoops = false;
+	gb.blockCache.fuseOps = false;
+
+	// the serial bytes (and the counters) were already sent the first time around
+	replay.serialOutput = gb.memory.serialOutput;
+	gb.memory.serialOutput = NULL;
+	STATS(replayStats.CopyCounters(gb.stats));
+}
+
+// responsible for putting back what a replay turned off
+void Rewind::EndReplay(const Replay &replay)
+{
+	gb.blockCache.idleLoops = replay.idleLoops;
+	gb.blockCache.fuseOps = replay.fuseOps;
+	gb.memory.serialOutput = replay.serialOutput;
+	STATS(gb.stats.CopyCounters(replayStats));
+}
+
+// responsible for going back to the last cpu step, by running forward from the nearest snapshot before it
+bool Rewind::StepBackInstruction()
+{
+	const long long target = gb.cpu.totalCycles;
+	const int frameCycles = gb.cpu.cycles;
+	int steps = 0;
+
+	if (!Seek(target - 1)) return false;
+
+	Replay replay;
+	BeginReplay(replay);
+
+	// count the steps up to where the machine is now, then run all but the last of them again
+	while (gb.cpu.totalCycles < target && !gb.cpu.stopMachine)
+	{
+		gb.cpu.Step();
+		steps += 1;
+	}
+
+	gb.LoadState(&latest[0], latest.size());
+
+	for (int i = 1; i < steps; i++)
+	{
+		gb.cpu.Step();
+	}
+
+	EndReplay(replay);
+
+	// the replay doesn't cross frame boundaries, so put the frame's cycle count back the way it was
+	const int stepCycles = (int)(target - gb.cpu.totalCycles);
+
+	if (frameCycles >= stepCycles) gb.cpu.cycles = (frameCycles - stepCycles);
+
+	return true;
+}
+
+// responsible for going back to the first cpu step boundary at or after the given total cycles
+bool Rewind::RewindTo(long long cycles)
+{
+	if (!Seek(cycles)) return false;
+
+	Replay replay;
+	BeginReplay(replay);
+
+	while (gb.cpu.totalCycles < cycles && !gb.cpu.stopMachine)
+	{
+		gb.cpu.Step();
+	}
+
+	EndReplay(replay);
+
+	return true;
+}
+
+// responsible for loading the newest snapshot taken at or before the given total cycles
+bool Rewind::Seek(long long cycles)
+{
+	if (latest.empty()) return false;
+
+	const long long oldest = (deltas.empty()) ? latestCycles : deltas.front().cycles;
+
+	if (cycles < oldest) return false;
+
+	while (latestCycles > cycles) Pop();
+
+	gb.LoadState(&latest[0], latest.size());
+	framesSinceCapture = 0;
+
+	return true;
+}
+
+// responsible for storing the delta between the newest snapshot and the one just taken
+void Rewind::Push(long long cycles)
+{
+	encoded.resize((latest.size() * 2) + 16);
+
+	const size_t length = Encode(&latest[0], &scratch[0], latest.size(), &encoded[0]);
+
+	// older deltas can't be rebuilt without this one, so they all go if it doesn't fit
+	if (length > ring.size())
+	{
+		deltas.clear();
+		ringHead = 0;
+		return;
+	}
+
+	size_t start = ringHead;
+
+	if ((start + length) > ring.size()) start = 0;
+
+	Evict(start, (start + length));
+	memcpy(&ring[start], &encoded[0], length);
+
+	Delta delta = {start, length, cycles};
+	deltas.push_back(delta);
+	ringHead = (start + length);
+}
+
+// responsible for rolling the newest snapshot back by one delta
+void Rewind::Pop()
+{
+	const Delta &delta = deltas.back();
+
+	Decode(&ring[delta.offset], delta.length, &latest[0]);
+	latestCycles = delta.cycles;
+	ringHead = delta.offset;
+	deltas.pop_back();
+}
+
+// responsible for dropping the deltas in the way of a new one (and everything older, which depends on them)
+void Rewind::Evict(size_t start, size_t end)
+{
+	int newest = -1;
+
+	for (size_t i = 0; i < deltas.size(); i++)
+	{
+		if (deltas[i].offset < end && (deltas[i].offset + deltas[i].length) > start) newest = (int)i;
+	}
+
+	deltas.erase(deltas.begin(), (deltas.begin() + (newest + 1)));
+}
+
+// responsible for encoding the xor of two snapshots as runs of (unchanged count, changed count, changed bytes)
+size_t Rewind::Encode(const u8 *older, const u8 *newer, size_t size, u8 *out)
+{
+	size_t pos = 0;
+	size_t length = 0;
+
+	while (pos < size)
+	{
+		size_t skip = 0;
+
+		while ((pos + skip) < size && skip < REWIND_MAX_RUN && older[pos + skip] == newer[pos + skip])
+		{
+			skip += 1;
+		}
+
+		pos += skip;
+
+		// the literal run carries on over short unchanged gaps
+		size_t count = 0;
+		size_t same = 0;
+
+		while ((pos + count) < size && count < REWIND_MAX_RUN)
+		{
+			same = (older[pos + count] == newer[pos + count]) ? (same + 1) : 0;
+
+			if (same >= REWIND_MIN_SKIP) break;
+
+			count += 1;
+		}
+
+		if (same >= REWIND_MIN_SKIP) count -= (same - 1);
+
+		out[length++] = (skip & 0xFF);
+		out[length++] = (skip >> 8);
+		out[length++] = (count & 0xFF);
+		out[length++] = (count >> 8);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			out[length++] = (older[pos + i] ^ newer[pos + i]);
+		}
+
+		pos += count;
+	}
+
+	return length;
+}
+
+// responsible for applying an encoded delta to a snapshot (xor works both ways, so this turns the newer one back into the older one)
+void Rewind::Decode(const u8 *delta, size_t length, u8 *snapshot)
+{
+	size_t read = 0;
+	size_t pos = 0;
+
+	while (read < length)
+	{
+		const size_t skip = (delta[read] | (delta[read + 1] << 8));
+		const size_t count = (delta[read + 2] | (delta[read + 3] << 8));
+		read += 4;
+		pos += skip;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			snapshot[pos++] ^= delta[read++];
+		}
+	}
+}
@@ -7,23 +7,36 @@
  * Copyright 2017 - Danny Glover. All rights reserved.
  */
 
-#include "includes/memory.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/rom.h"
-#include "tinyfiledialogs/tinyfiledialogs.h"
-
-// init vars
-u8 Rom::rom[0x4000 * 512] = {0x00};
-u8 Rom::ram[0x2000 * 16] = {0x00};
-u8 Rom::mbcType = 0x00;
-u8 Rom::romSize = 0x00;
-u8 Rom::ramSize = 0x00;
-u16 Rom::romBank = 0x01;
-u8 Rom::ramBank = 0x00;
-u8 Rom::currentMode = 0x00;
-bool Rom::hasBatteryBackup = false;
-const char *Rom::filename = NULL;
-char Rom::romName[256];
+
+// definitions
+#define MAX_ROM_BANKS 512
+
+// responsible for constructing the rom (an empty cartridge until one is loaded)
+Rom::Rom(GameBoy &gb) :
+	rom(new u8[(2 * 0x4000) + 1]()),
+	ram(),
+	mbcType(0x00),
+	romSize(0x00),
+	ramSize(0x00),
+	romBank(0x01),
+	romBankMask(0x01),
+	ramBank(0x00),
+	currentMode(0x00),
+	hasBatteryBackup(false),
+	filename(NULL),
+	romName(),
+	gb(gb)
+{
+
+}
+
+// responsible for freeing the rom
+Rom::~Rom()
+{
+	delete[] rom;
+}
 
 // responsible for loading a rom
 bool Rom::Load(const char *filePath)
@@ -37,17 +50,43 @@ bool Rom::Load(const char *filePath)
 		ramSize = 0x00;
 		currentMode = 0x00;
 
+		// size the rom to the file, rounded up to a power of two amount of banks
+		fseek(gbRom, 0, SEEK_END);
+		const long fileSize = ftell(gbRom);
+		fseek(gbRom, 0, SEEK_SET);
+		u16 bankCount = 2;
+
+		while ((bankCount < MAX_ROM_BANKS) && ((bankCount * 0x4000) < fileSize)) bankCount <<= 1;
+
+		u8 header[0x150] = {0x00};
+		fread(header, 1, sizeof(header), gbRom);
+		fseek(gbRom, 0, SEEK_SET);
+
+		// the header may claim more banks than the file holds
+		if (header[Memory::Address::ROM_SIZE] <= 0x8)
+		{
+			const u16 headerBanks = (0x2 << header[Memory::Address::ROM_SIZE]);
+			if (headerBanks > bankCount) bankCount = headerBanks;
+		}
+
+		delete[] rom;
+		// the extra byte covers a word read from the very end of the last bank
+		rom = new u8[(bankCount * 0x4000) + 1];
+		romBankMask = (bankCount - 1);
+
 		memset(&romName, 0, sizeof(romName));
-		memset(&rom, 0x00, sizeof(rom));
+		memset(rom, 0x00, (bankCount * 0x4000) + 1);
 		memset(&ram, 0x00, sizeof(ram));
-		fread(&rom, 1, sizeof(rom), gbRom);
-		memcpy(&Memory::mem, &rom, 0x3FFF);
+		fread(rom, 1, (bankCount * 0x4000), gbRom);
+		memcpy(&gb.memory.mem, rom, 0x3FFF);
+		gb.memory.MapPages();
+		gb.blockCache.Flush();
 
 		result = true;
 		filename = filePath;
-		mbcType = Memory::ReadByte(Memory::Address::ROM_TYPE);
-		romSize = Memory::ReadByte(Memory::Address::ROM_SIZE);
-		ramSize = Memory::ReadByte(Memory::Address::ROM_RAM_SIZE);
+		mbcType = gb.memory.ReadByte(Memory::Address::ROM_TYPE);
+		romSize = gb.memory.ReadByte(Memory::Address::ROM_SIZE);
+		ramSize = gb.memory.ReadByte(Memory::Address::ROM_RAM_SIZE);
 
 		switch(mbcType)
 		{
@@ -59,54 +98,37 @@ bool Rom::Load(const char *filePath)
 		}
 
 		Log::Print("Loaded rom '%s' successfully", filePath);
-		printf("Rom Name: ");
+		char title[Memory::Address::ROM_NAME_END - Memory::Address::ROM_NAME_START + 1] = {0};
 
 		for (u16 i = Memory::Address::ROM_NAME_START; i < Memory::Address::ROM_NAME_END; i++)
 		{
-			printf("%c", Memory::ReadByte(i));
-			sprintf(romName, "%s%02X", romName, Memory::ReadByte(i));
+			title[i - Memory::Address::ROM_NAME_START] = gb.memory.ReadByte(i);
+			sprintf(romName, "%s%02X", romName, gb.memory.ReadByte(i));
 		}
 
 		// calculate the rom checksum (from the cartridge header)
 		u8 sum = 0;
 		for(u16 i = 0x0134; i <= 0x014C; i++)
 		{
-			sum = (sum - Memory::ReadByte(i));
+			sum = (sum - gb.memory.ReadByte(i));
 		}
 
 		sprintf(romName, "%s%02X", romName, sum);
 
-		printf("\n");
+		Log::Print("Rom Name: %s", title);
 		Log::Print("Rom Cartridge Type: %02X | Rom-Size: %02X | Ram-Size: %02X", mbcType, romSize, ramSize);
 
 		LoadRam();
+		fclose(gbRom);
 	}
 	else
 	{
 		Log::Critical("Failed to load rom at filepath: '%s'", filePath);
 	}
 
-	fclose(gbRom);
-
 	return result;
 }
 
-// responsible for selecting a rom from the file system
-bool Rom::Select()
-{
-	char const *validExtensions[4] = {"*.gb", "*.GB", "*.bin", "*.BIN"};
-	const char *filePath = tinyfd_openFileDialog("Select Rom", "", 4, validExtensions, NULL, 0);
-	filename = filePath;
-
-	if (filePath != NULL)
-	{
-		Load(filePath);
-		return true;
-	}
-
-	return false;
-}
-
 // responsible for reloading a previously loaded rom
 void Rom::Reload()
 {
@@ -134,7 +156,7 @@ bool Rom::LoadRam(int num)
 
 	if (fp == NULL) return false;
 
-	fread(&Rom::ram, 1, sizeof(Rom::ram), fp);
+	fread(&ram, 1, sizeof(ram), fp);
 	fclose(fp);
 
 	return true;
@@ -157,6 +179,24 @@ void Rom::SaveRam(int num)
 
 	FILE *fp = fopen(outputFilename, "wb");
 
-	fwrite(Rom::ram, sizeof(Rom::ram), 1, fp);
+	fwrite(ram, sizeof(ram), 1, fp);
 	fclose(fp);
 }
+
+// responsible for saving/loading the rom banking state and as much external ram as the cartridge has
+void Rom::Serialize(StateBuffer &state)
+{
+	size_t ramBytes = 0x2000;
+
+	switch(ramSize)
+	{
+		case 0x3: ramBytes = 0x8000; break;
+		case 0x4: ramBytes = 0x20000; break;
+		case 0x5: ramBytes = 0x10000; break;
+	}
+
+	state.Bytes(ram, ramBytes);
+	state.Value(romBank);
+	state.Value(ramBank);
+	state.Value(currentMode);
+}
@@ -0,0 +1,75 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include "includes/gameboy.h"
+#include "includes/scheduler.h"
+
+// responsible for constructing the scheduler
+Scheduler::Scheduler(GameBoy &gb) : elapsed(0), nextEvent(0), gb(gb), timerEvent(0), lcdEvent(0)
+{
+
+}
+
+// responsible for initializing the scheduler
+void Scheduler::Init()
+{
+	elapsed = 0;
+	nextEvent = 0;
+	timerEvent = 0;
+	lcdEvent = 0;
+}
+
+// responsible for running whichever events are due (cycles = the length of the step that reached them)
+void Scheduler::Run(int cycles)
+{
+	// nothing happened during the earlier steps, so they only need adding to the counters
+	const int skipped = (elapsed - cycles);
+
+	// the step that reached an event is run exactly as it always has been
+	if (elapsed >= timerEvent)
+	{
+		gb.timer.Advance(skipped);
+		gb.timer.Update(cycles);
+		timerEvent = gb.timer.NextEvent();
+	}
+	else
+	{
+		gb.timer.Advance(elapsed);
+		timerEvent -= elapsed;
+	}
+
+	if (elapsed >= lcdEvent)
+	{
+		gb.lcd.Advance(skipped);
+		gb.lcd.Update(cycles);
+		lcdEvent = gb.lcd.NextEvent();
+	}
+	else
+	{
+		gb.lcd.Advance(elapsed);
+		lcdEvent -= elapsed;
+	}
+
+	elapsed = 0;
+	nextEvent = (timerEvent < lcdEvent) ? timerEvent : lcdEvent;
+}
+
+// responsible for bringing the counters up to date (ie. before a timer or lcd register changes)
+void Scheduler::Sync()
+{
+	gb.timer.Advance(elapsed);
+	gb.lcd.Advance(elapsed);
+
+	// the registers may have changed, so work every event out again at the end of this step
+	elapsed = 0;
+	nextEvent = 0;
+	timerEvent = 0;
+	lcdEvent = 0;
+}
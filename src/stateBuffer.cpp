@@ -0,0 +1,53 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include "includes/stateBuffer.h"
+
+// responsible for constructing a state buffer to save into (pass NULL to only measure the state)
+StateBuffer::StateBuffer(u8 *data, size_t size) : loading(false), data(data), size(size), offset(0), failed(false)
+{
+
+}
+
+// responsible for constructing a state buffer to load from
+StateBuffer::StateBuffer(const u8 *data, size_t size) : loading(true), data((u8 *)data), size(size), offset(0), failed(false)
+{
+
+}
+
+// responsible for copying a block of state to/from the buffer
+void StateBuffer::Bytes(void *value, size_t length)
+{
+	if (data != NULL)
+	{
+		if (failed || (offset + length) > size)
+		{
+			failed = true;
+			return;
+		}
+
+		if (loading) memcpy(value, &data[offset], length);
+		else memcpy(&data[offset], value, length);
+	}
+
+	offset += length;
+}
+
+// responsible for returning how many bytes have been read/written so far
+size_t StateBuffer::Offset()
+{
+	return offset;
+}
+
+// responsible for returning whether the buffer ran out of room
+bool StateBuffer::Failed()
+{
+	return failed;
+}
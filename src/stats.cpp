@@ -0,0 +1,129 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include "includes/gameboy.h"
+#include "includes/log.h"
+#include "includes/stats.h"
+
+// init vars
+static const char *regionNames[Stats::REGION_COUNT] = {"rom0", "romx", "vram", "eram", "wram", "oam", "io", "hram"};
+static const char *interruptNames[STATS_INTERRUPT_COUNT] = {"vblank", "lcd", "timer", "serial", "joypad"};
+
+// responsible for constructing the stats
+Stats::Stats(GameBoy &gb) : gb(gb)
+{
+	Reset();
+}
+
+// responsible for returning whether the counters were compiled in
+bool Stats::Available()
+{
+	#ifdef COLLECT_STATS
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+// responsible for zeroing every counter
+void Stats::Reset()
+{
+	memset(opcodeCount, 0, sizeof(opcodeCount));
+	memset(opcodeCycles, 0, sizeof(opcodeCycles));
+	memset(extendedCount, 0, sizeof(extendedCount));
+	memset(extendedCycles, 0, sizeof(extendedCycles));
+	memset(reads, 0, sizeof(reads));
+	memset(writes, 0, sizeof(writes));
+	memset(interrupts, 0, sizeof(interrupts));
+	haltedCycles = 0;
+	idleLoopCycles = 0;
+	romBankSwitches = 0;
+	ramBankSwitches = 0;
+}
+
+// responsible for copying every counter from another set of stats (ie. into a snapshot for the ui)
+void Stats::CopyCounters(const Stats &other)
+{
+	memcpy(opcodeCount, other.opcodeCount, sizeof(opcodeCount));
+	memcpy(opcodeCycles, other.opcodeCycles, sizeof(opcodeCycles));
+	memcpy(extendedCount, other.extendedCount, sizeof(extendedCount));
+	memcpy(extendedCycles, other.extendedCycles, sizeof(extendedCycles));
+	memcpy(reads, other.reads, sizeof(reads));
+	memcpy(writes, other.writes, sizeof(writes));
+	memcpy(interrupts, other.interrupts, sizeof(interrupts));
+	haltedCycles = other.haltedCycles;
+	idleLoopCycles = other.idleLoopCycles;
+	romBankSwitches = other.romBankSwitches;
+	ramBankSwitches = other.ramBankSwitches;
+}
+
+// responsible for counting the banks that changed since the given ones were selected
+void Stats::CountBanking(u16 romBank, u8 ramBank)
+{
+	if (gb.rom.romBank != romBank) romBankSwitches += 1;
+	if (gb.rom.ramBank != ramBank) ramBankSwitches += 1;
+}
+
+// responsible for writing every non zero counter to a csv file ("kind,name,count,cycles" per line)
+bool Stats::DumpCsv(const char *filePath)
+{
+	FILE *fp = fopen(filePath, "w");
+
+	if (fp == NULL)
+	{
+		Log::Critical("Failed to write stats to: '%s'", filePath);
+		return false;
+	}
+
+	fprintf(fp, "kind,name,count,cycles\n");
+
+	for (int i = 0; i < 0x100; i++)
+	{
+		if (opcodeCount[i] > 0) fprintf(fp, "opcode,%02X,%lld,%lld\n", i, opcodeCount[i], opcodeCycles[i]);
+	}
+
+	for (int i = 0; i < 0x100; i++)
+	{
+		if (extendedCount[i] > 0) fprintf(fp, "cb,%02X,%lld,%lld\n", i, extendedCount[i], extendedCycles[i]);
+	}
+
+	fprintf(fp, "halt,halt,,%lld\n", haltedCycles);
+	fprintf(fp, "idle,loop,,%lld\n", idleLoopCycles);
+
+	for (int i = 0; i < REGION_COUNT; i++)
+	{
+		fprintf(fp, "read,%s,%lld,\n", regionNames[i], reads[i]);
+		fprintf(fp, "write,%s,%lld,\n", regionNames[i], writes[i]);
+	}
+
+	fprintf(fp, "bank,rom,%lld,\n", romBankSwitches);
+	fprintf(fp, "bank,ram,%lld,\n", ramBankSwitches);
+
+	for (int i = 0; i < STATS_INTERRUPT_COUNT; i++)
+	{
+		fprintf(fp, "interrupt,%s,%lld,\n", interruptNames[i], interrupts[i]);
+	}
+
+	fclose(fp);
+
+	return true;
+}
+
+// responsible for returning the name of a memory region
+const char *Stats::RegionName(int region)
+{
+	return regionNames[region];
+}
+
+// responsible for returning the name of an interrupt
+const char *Stats::InterruptName(int id)
+{
+	return interruptNames[id];
+}
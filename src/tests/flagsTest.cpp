@@ -0,0 +1,304 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// checks the flag lookup tables in flags.cpp against the original cpu operations, which set F bit by bit,
+// for every operand and F value (exits non zero if anything differs)
+
+// includes
+#include <cstdio>
+#include "../includes/bit.h"
+#include "../includes/flags.h"
+
+// definitions
+#define MAX_REPORTED 16
+
+// the F register as the original cpu operations worked on it, with every flag landing straight away
+class ReferenceFlags
+{
+	public:
+		ReferenceFlags(u8 &f) : f(f) {}
+		u8 Get(u8 flag) { return (f & flag) ? 1 : 0; }
+		void Set(u8 flags) { f |= flags; }
+		void Clear(u8 flags) { f &= ~flags; }
+
+	private:
+		u8 &f;
+};
+
+// the 8 bit alu operations the tables stand in for
+enum Operation { ADD, ADC, SUB, SBC, CMP, AND, OR, XOR, INC, DEC, OPERATIONS };
+
+// the flag logic below is the original CpuOps code, only with the cycle counting taken out
+
+static void Add8(ReferenceFlags &flags, u8 &in, u8 val)
+{
+	const u8 result = (in + val);
+
+	flags.Clear(Flags::all);
+
+	if (result == 0) flags.Set(Flags::z);
+	if (Bit::DidHalfCarry(in, val, 0xF)) flags.Set(Flags::h);
+	if (Bit::DidCarry((u16)(in + val), 0xFF)) flags.Set(Flags::c);
+
+	in = result;
+}
+
+static void Adc8(ReferenceFlags &flags, u8 &in, u8 val)
+{
+	const u8 carry = flags.Get(Flags::c);
+	const u8 result = (in + carry + val);
+
+	flags.Clear(Flags::all);
+
+	if (result == 0) flags.Set(Flags::z);
+	if (Bit::DidHalfCarry(in, carry, 0xF)) flags.Set(Flags::h);
+	if (Bit::DidHalfCarry(in + carry, val, 0xF)) flags.Set(Flags::h);
+	if (Bit::DidCarry((u16)(in + carry), 0xFF)) flags.Set(Flags::c);
+	if (Bit::DidCarry((u16)(in + carry + val), 0xFF)) flags.Set(Flags::c);
+
+	in = result;
+}
+
+static void Sub8(ReferenceFlags &flags, u8 &in, u8 val)
+{
+	const u8 result = (in - val);
+
+	flags.Clear(Flags::z | Flags::h | Flags::c);
+	flags.Set(Flags::n);
+
+	if (result == 0) flags.Set(Flags::z);
+	if ((in & 0xF) < (val & 0xF)) flags.Set(Flags::h);
+	if (in < val) flags.Set(Flags::c);
+
+	in = result;
+}
+
+static void Sbc8(ReferenceFlags &flags, u8 &in, u8 sub)
+{
+	const u8 carry = flags.Get(Flags::c);
+	const u8 result = (in - carry - sub);
+
+	flags.Clear(Flags::z | Flags::h | Flags::c);
+	flags.Set(Flags::n);
+
+	if (result == 0) flags.Set(Flags::z);
+	if ((in & 0xF) < (carry & 0xF)) flags.Set(Flags::h);
+	if (((in - carry) & 0xF) < (sub & 0xF)) flags.Set(Flags::h);
+	if (in < carry) flags.Set(Flags::c);
+	if ((in - carry) < sub) flags.Set(Flags::c);
+
+	in = result;
+}
+
+static void Inc8(ReferenceFlags &flags, u8 &in)
+{
+	const u8 result = (in + 1);
+
+	flags.Clear(Flags::z | Flags::n | Flags::h);
+
+	if (result == 0) flags.Set(Flags::z);
+	if ((result & 0xF) == 0) flags.Set(Flags::h);
+
+	in = result;
+}
+
+static void Dec8(ReferenceFlags &flags, u8 &in)
+{
+	const u8 result = (in - 1);
+
+	flags.Clear(Flags::z | Flags::h);
+	flags.Set(Flags::n);
+
+	if (result == 0) flags.Set(Flags::z);
+	if ((result & 0xF) == 0xF) flags.Set(Flags::h);
+
+	in = result;
+}
+
+static void Cmp8(ReferenceFlags &flags, u8 &in, u8 compare)
+{
+	const u8 result = (in - compare);
+
+	flags.Clear(Flags::z | Flags::h | Flags::c);
+	flags.Set(Flags::n);
+
+	if (result == 0) flags.Set(Flags::z);
+	if ((in & 0xF) < (compare & 0xF)) flags.Set(Flags::h);
+	if (in < compare) flags.Set(Flags::c);
+}
+
+static void And8(ReferenceFlags &flags, u8 &in, u8 val)
+{
+	const u8 result = (in & val);
+
+	flags.Clear(Flags::z | Flags::n | Flags::c);
+	flags.Set(Flags::h);
+
+	if (result == 0) flags.Set(Flags::z);
+
+	in = result;
+}
+
+static void Or8(ReferenceFlags &flags, u8 &in, u8 val)
+{
+	const u8 result = (in | val);
+
+	flags.Clear(Flags::all);
+
+	if (result == 0) flags.Set(Flags::z);
+
+	in = result;
+}
+
+static void Xor8(ReferenceFlags &flags, u8 &in, u8 val)
+{
+	const u8 result = (in ^ val);
+
+	flags.Clear(Flags::all);
+
+	if (result == 0) flags.Set(Flags::z);
+
+	in = result;
+}
+
+static void Daa(ReferenceFlags &flags, u8 &a)
+{
+	unsigned int adjusted = a;
+
+	if (!flags.Get(Flags::n))
+	{
+		if ((flags.Get(Flags::h)) || ((adjusted & 0xF) > 0x09)) adjusted += 0x06;
+		if ((flags.Get(Flags::c)) || (adjusted > 0x9F)) adjusted += 0x60;
+	}
+	else
+	{
+		if (flags.Get(Flags::h)) adjusted = ((adjusted - 0x06) & 0xFF);
+		if (flags.Get(Flags::c)) adjusted -= 0x60;
+	}
+
+	if (adjusted & 0x100) flags.Set(Flags::c);
+	adjusted &= 0xFF;
+
+	flags.Clear(Flags::z | Flags::h);
+
+	if (adjusted == 0) flags.Set(Flags::z);
+
+	a = adjusted;
+}
+
+// responsible for running an operation the original way
+static void RunReference(int operation, u8 &f, u8 &in, u8 val)
+{
+	ReferenceFlags flags(f);
+
+	switch(operation)
+	{
+		case ADD: Add8(flags, in, val); break;
+		case ADC: Adc8(flags, in, val); break;
+		case SUB: Sub8(flags, in, val); break;
+		case SBC: Sbc8(flags, in, val); break;
+		case CMP: Cmp8(flags, in, val); break;
+		case AND: And8(flags, in, val); break;
+		case OR: Or8(flags, in, val); break;
+		case XOR: Xor8(flags, in, val); break;
+		case INC: Inc8(flags, in); break;
+		case DEC: Dec8(flags, in); break;
+	}
+}
+
+// responsible for running an operation the way CpuOps records it now, then reading the flags back from the tables
+static void RunTables(int operation, u8 &f, u8 &in, u8 val)
+{
+	Flags flags(f);
+	u8 carry = 0;
+
+	switch(operation)
+	{
+		case ADD: flags.Defer(Flags::ADD, in, val); in += val; break;
+		case ADC: carry = flags.Get(Flags::c); flags.Defer(Flags::ADC, in, val, carry); in += (carry + val); break;
+		case SUB: flags.Defer(Flags::SUB, in, val); in -= val; break;
+		case SBC: carry = flags.Get(Flags::c); flags.Defer(Flags::SBC, in, val, carry); in -= (carry + val); break;
+		case CMP: flags.Defer(Flags::SUB, in, val); break;
+		case AND: flags.Defer(Flags::AND, in, val); in &= val; break;
+		case OR: in |= val; flags.Defer(Flags::OR, in, 0); break;
+		case XOR: in ^= val; flags.Defer(Flags::OR, in, 0); break;
+		case INC: flags.Defer(Flags::INC, in, 1); in += 1; break;
+		case DEC: flags.Defer(Flags::DEC, in, 1); in -= 1; break;
+	}
+
+	flags.Resolve();
+}
+
+// responsible for checking every alu operation, operand and F value (returns the number of mismatches)
+static int CheckAlu()
+{
+	int mismatches = 0;
+
+	for (int operation = 0; operation < OPERATIONS; operation++)
+	{
+		// inc/dec have no second operand
+		const int maxVal = (operation == INC || operation == DEC) ? 0x00 : 0xFF;
+
+		for (int lhs = 0; lhs <= 0xFF; lhs++)
+		{
+			for (int val = 0; val <= maxVal; val++)
+			{
+				for (int f = 0; f <= 0xFF; f++)
+				{
+					u8 referenceIn = lhs, referenceF = f;
+					u8 tableIn = lhs, tableF = f;
+
+					RunReference(operation, referenceF, referenceIn, val);
+					RunTables(operation, tableF, tableIn, val);
+
+					if (tableIn == referenceIn && tableF == referenceF) continue;
+					if (mismatches++ < MAX_REPORTED) printf("alu mismatch: operation %d lhs %02X val %02X F %02X: got %02X/%02X, expected %02X/%02X\n", operation, lhs, val, f, tableIn, tableF, referenceIn, referenceF);
+				}
+			}
+		}
+	}
+
+	return mismatches;
+}
+
+// responsible for checking daa for every A and F value (returns the number of mismatches)
+static int CheckDaa()
+{
+	int mismatches = 0;
+
+	for (int a = 0; a <= 0xFF; a++)
+	{
+		for (int f = 0; f <= 0xFF; f++)
+		{
+			u8 referenceA = a, referenceF = f;
+			u8 tableA = a, tableF = f;
+			ReferenceFlags reference(referenceF);
+			Flags flags(tableF);
+
+			Daa(reference, referenceA);
+			flags.Daa(tableA);
+
+			if (tableA == referenceA && tableF == referenceF) continue;
+			if (mismatches++ < MAX_REPORTED) printf("daa mismatch: A %02X F %02X: got %02X/%02X, expected %02X/%02X\n", a, f, tableA, tableF, referenceA, referenceF);
+		}
+	}
+
+	return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+	const int aluMismatches = CheckAlu();
+	const int daaMismatches = CheckDaa();
+
+	printf("alu: %d mismatches\n", aluMismatches);
+	printf("daa: %d mismatches\n", daaMismatches);
+
+	return ((aluMismatches + daaMismatches) > 0) ? 1 : 0;
+}
@@ -9,26 +9,30 @@
 
 // includes
 #include "includes/bit.h"
-#include "includes/interrupts.h"
-#include "includes/memory.h"
-#include "includes/timer.h"
+#include "includes/gameboy.h"
+#include "includes/profiler.h"
 
 // definitions
-#define TIMA Memory::mem[Memory::Address::TIMA]
-#define TAC Memory::ReadByte(Memory::Address::TAC)
-#define TMA Memory::ReadByte(Memory::Address::TMA)
-#define DIV Memory::mem[Memory::Address::DIV]
+#define TIMA gb.memory.mem[Memory::Address::TIMA]
+#define TAC gb.memory.mem[Memory::Address::TAC]
+#define TMA gb.memory.mem[Memory::Address::TMA]
+#define DIV gb.memory.mem[Memory::Address::DIV]
 
 // init vars
-int Timer::timerCounter = 0;
-int Timer::divCounter = 0;
 static const u16 frequencies[4] = {1024, 16, 64, 256};
 
+// responsible for constructing the timer
+Timer::Timer(GameBoy &gb) : timerCounter(0), divCounter(0), counting(false), gb(gb)
+{
+
+}
+
 // responsible for initializing the timer
 void Timer::Init()
 {
 	timerCounter = 0;
 	divCounter = 0;
+	counting = false;
 }
 
 // responsible for getting the current frequency
@@ -58,6 +62,8 @@ void Timer::UpdateDiv(int cycles)
 // responsible for updating the timer
 void Timer::Update(int cycles)
 {
+	PROFILE_SECTION(Profiler::TIMER);
+
 	UpdateDiv(cycles);
 
 	if (!Enabled()) return;
@@ -70,7 +76,7 @@ void Timer::Update(int cycles)
 		if (((u16)TIMA + 1) > 255)
 		{
 			TIMA = TMA;
-			Interrupts::Request(Interrupts::TIMER);
+			gb.interrupts.Request(Interrupts::TIMER);
 		}
 
 		TIMA += 1;
@@ -78,3 +84,37 @@ void Timer::Update(int cycles)
 		timerCounter -= currentFrequency;
 	}
 }
+
+// responsible for adding cycles that passed without an event to the counters
+void Timer::Advance(int cycles)
+{
+	divCounter += cycles;
+
+	if (counting) timerCounter += cycles;
+}
+
+// responsible for working out how many cycles until DIV ticks or TIMA next increments
+int Timer::NextEvent()
+{
+	int cycles = (256 - divCounter);
+
+	// TAC can only change by being written to, which syncs the scheduler
+	counting = Enabled();
+
+	if (counting)
+	{
+		const int overflow = (GetFrequency() - timerCounter);
+
+		if (overflow < cycles) cycles = overflow;
+	}
+
+	return cycles;
+}
+
+// responsible for saving/loading the timer state
+void Timer::Serialize(StateBuffer &state)
+{
+	state.Value(timerCounter);
+	state.Value(divCounter);
+	state.Value(counting);
+}
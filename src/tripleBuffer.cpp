@@ -0,0 +1,43 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include "includes/tripleBuffer.h"
+
+// definitions
+#define TRIPLE_BUFFER_FRESH 0x4
+#define TRIPLE_BUFFER_INDEX 0x3
+
+// responsible for constructing the triple buffer
+TripleBuffer::TripleBuffer() : buffers(), back(0), front(1), middle(2)
+{
+
+}
+
+// responsible for returning the buffer the next frame should be written to
+u8 *TripleBuffer::GetBackBuffer()
+{
+	return buffers[back];
+}
+
+// responsible for handing the back buffer over to the consumer (an unread frame is simply replaced)
+void TripleBuffer::Publish()
+{
+	back = (middle.exchange(back | TRIPLE_BUFFER_FRESH, std::memory_order_acq_rel) & TRIPLE_BUFFER_INDEX);
+}
+
+// responsible for taking the newest published frame (returns NULL if nothing new was published)
+const u8 *TripleBuffer::Acquire()
+{
+	if (!(middle.load(std::memory_order_relaxed) & TRIPLE_BUFFER_FRESH)) return NULL;
+
+	front = (middle.exchange(front, std::memory_order_acq_rel) & TRIPLE_BUFFER_INDEX);
+
+	return buffers[front];
+}
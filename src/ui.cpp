@@ -12,24 +12,31 @@
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_sdl.h"
 #include "imgui/imgui_custom_extensions.h"
-#include "includes/cpu.h"
 #include "includes/debugger.h"
-#include "includes/memory.h"
+#include "includes/emulationThread.h"
+#include "includes/gameboy.h"
 #include "includes/log.h"
-#include "includes/rom.h"
 #include "includes/ui.h"
+#include "tinyfiledialogs/tinyfiledialogs.h"
 
 // init vars
+int Ui::speed = 1;
+bool Ui::turbo = false;
 char Ui::statusText[512] = {0};
 char Ui::statusTextTitle[256] = {0};
 const char *statusWindowTitle = "Status Overlay";
+static const char *fpsWindowTitle = "Fps Overlay";
 static const char *aboutPopupTitle = "About";
 static int currentPopup = -1;
 static bool showPopup = false;
 static bool hideMainMenu = false;
 static bool hideStatusWindow = true;
+static bool showFps = false;
+static double emulatedFps = 0;
+static double hostFps = 0;
 static int statusMessageHideTime = (3 * 1000);
 static SDL_TimerID timerId;
+static GameBoy *gb = NULL;
 
 // responsible for executing upon a timer callback
 static Uint32 timerCallback(Uint32 interval, void* param)
@@ -44,6 +51,12 @@ static Uint32 timerCallback(Uint32 interval, void* param)
     return 0;
 }
 
+// responsible for attaching the ui to a machine
+void Ui::Init(GameBoy *gameBoy)
+{
+	gb = gameBoy;
+}
+
 // responsible for displaying the status window
 void Ui::StatusWindowOverlay()
 {
@@ -62,6 +75,25 @@ void Ui::StatusWindowOverlay()
 	ImGui::End();
 }
 
+// responsible for displaying the emulated and host frame rates
+void Ui::FpsOverlay()
+{
+	if (!showFps) return;
+
+	ImGui::Begin(fpsWindowTitle, NULL, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoInputs);
+	ImGui::SetWindowSize(fpsWindowTitle, ImVec2(300, 30));
+	ImGui::SetWindowPos(fpsWindowTitle, ImVec2(0, 450));
+	ImGui::Text("Emulated: %.1f fps  Host: %.1f fps", emulatedFps, hostFps);
+	ImGui::End();
+}
+
+// responsible for updating the frame rate readouts
+void Ui::SetFps(double emulated, double host)
+{
+	emulatedFps = emulated;
+	hostFps = host;
+}
+
 // responsible for hiding the status window
 void Ui::ShowStatusWindow()
 {
@@ -87,6 +119,96 @@ void Ui::SetStatusMessage(const char *title, const char *msg)
 	ShowStatusWindow();
 }
 
+// responsible for selecting a rom from the file system (the machine keeps running while the dialog is open)
+bool Ui::SelectRom(bool reset)
+{
+	char const *validExtensions[4] = {"*.gb", "*.GB", "*.bin", "*.BIN"};
+	const char *filePath = tinyfd_openFileDialog("Select Rom", "", 4, validExtensions, NULL, 0);
+
+	EmulationThread::Lock();
+
+	if (reset) Debugger::ResetSystem();
+	gb->rom.filename = filePath;
+	if (filePath != NULL) gb->rom.Load(filePath);
+
+	EmulationThread::Unlock();
+
+	return (filePath != NULL);
+}
+
+// responsible for saving a state and reporting where it went
+void Ui::SaveState()
+{
+	char filePath[512];
+
+	EmulationThread::Lock();
+	gb->cpu.SaveState(false);
+	sprintf(filePath, "saves/states/%s/state_%d.bin", gb->rom.romName, 0);
+	EmulationThread::Unlock();
+	SetStatusMessage("Saved State at path: ", filePath);
+}
+
+// responsible for loading a state and reporting the result
+void Ui::LoadState()
+{
+	char filePath[512];
+
+	EmulationThread::Lock();
+	const bool loaded = gb->cpu.LoadState(false);
+	if (!loaded) gb->cpu.stopMachine = false;
+	sprintf(filePath, "saves/states/%s/state_%d.bin", gb->rom.romName, 0);
+	EmulationThread::Unlock();
+
+	if (loaded)
+	{
+		SetStatusMessage("Loaded State at path: ", filePath);
+	}
+	else
+	{
+		SetStatusMessage("Failed To Load State", "The state could not be found");
+	}
+}
+
+// responsible for recording a movie from the current state
+void Ui::RecordMovie()
+{
+	char filePath[512];
+
+	EmulationThread::Lock();
+	sprintf(filePath, "saves/movies/%s.dbm", gb->rom.romName);
+	const bool recording = gb->movie.Record(filePath);
+	EmulationThread::Unlock();
+
+	if (recording) SetStatusMessage("Recording Movie to: ", filePath);
+	else SetStatusMessage("Failed To Record Movie", "Load a rom first");
+}
+
+// responsible for playing back the rom's movie
+void Ui::PlayMovie()
+{
+	char filePath[512];
+
+	EmulationThread::Lock();
+	sprintf(filePath, "saves/movies/%s.dbm", gb->rom.romName);
+	const bool playing = gb->movie.Play(filePath);
+	EmulationThread::Unlock();
+
+	if (playing) SetStatusMessage("Playing Movie from: ", filePath);
+	else SetStatusMessage("Failed To Play Movie", "The movie could not be found, or was recorded with another rom");
+}
+
+// responsible for stopping the movie being recorded/played
+void Ui::StopMovie()
+{
+	char frames[64];
+
+	EmulationThread::Lock();
+	sprintf(frames, "%d frames", gb->movie.frame);
+	gb->movie.Stop();
+	EmulationThread::Unlock();
+	SetStatusMessage("Stopped Movie after: ", frames);
+}
+
 // responsible for hiding the main menu bar
 void Ui::HideMainMenuBar()
 {
@@ -129,7 +251,10 @@ void Ui::AboutPopupWindow()
 // responsible for displaying the UI
 void Ui::Render()
 {
+	const EmulationThread::Snapshot &machine = EmulationThread::GetSnapshot();
+
 	StatusWindowOverlay();
+	FpsOverlay();
 
 	if (hideMainMenu) return;
 
@@ -138,26 +263,21 @@ void Ui::Render()
 		// file menu
 		if (ImGui::BeginMenu("File"))
 		{
-			if (ImGui::MenuItem("Open Rom", "ctrl+o"))
-			{
-				Debugger::ResetSystem();
-				Rom::Select();
-			}
+			if (ImGui::MenuItem("Open Rom", "ctrl+o")) SelectRom(true);
 
 			if (ImGui::BeginMenu("State"))
 			{
-				if (ImGui::MenuItem("Load", "ctrl+l"))
-				{
-					if (!Cpu::LoadState(false))
-					{
-						const char *title = "Failed To Load State";
-						const char *desc = "The state could not be found";
-						Debugger::stopMachine = false;
-						SetStatusMessage(title, desc);
-					}
-				}
+				if (ImGui::MenuItem("Load", "ctrl+l")) LoadState();
+				if (ImGui::MenuItem("Save", "ctrl+s")) SaveState();
+
+				ImGui::EndMenu();
+			}
 
-				if (ImGui::MenuItem("Save", "ctrl+s")) Cpu::SaveState(false);
+			if (ImGui::BeginMenu("Movie"))
+			{
+				if (ImGui::MenuItem("Record", NULL, machine.recording)) RecordMovie();
+				if (ImGui::MenuItem("Play", NULL, machine.playing)) PlayMovie();
+				if (ImGui::MenuItem("Stop")) StopMovie();
 
 				ImGui::EndMenu();
 			}
@@ -166,7 +286,10 @@ void Ui::Render()
 
 			if (ImGui::MenuItem("Quit", "ctrl+q"))
 			{
-				Rom::SaveRam();
+				EmulationThread::Lock();
+				gb->rom.SaveRam();
+				gb->movie.Stop();
+				EmulationThread::Unlock();
 				Debugger::RemoveStates();
 				exit(0);
 			}
@@ -179,45 +302,88 @@ void Ui::Render()
 		{
 			if (ImGui::MenuItem("Run"))
 			{
-				if (Rom::HasLoaded())
+				if (machine.romLoaded)
 				{
-					Debugger::stepThrough = false;
-					Debugger::stopAtBreakpoint = false;
+					EmulationThread::SendCommand(EmulationThread::ResumeNoBreak);
 					hideMainMenu = true;
 				}
 			}
 
-			if (ImGui::MenuItem("Stop")) Debugger::stepThrough = true;
+			if (ImGui::MenuItem("Stop")) EmulationThread::SendCommand(EmulationThread::Pause);
 
 			if (ImGui::MenuItem("Reset"))
 			{
-				if (Rom::HasLoaded()) Debugger::ResetSystem(true);
+				if (machine.romLoaded) EmulationThread::SendCommand(EmulationThread::Restart);
 			}
 
+			if (ImGui::MenuItem("Rewind", "ctrl+b")) EmulationThread::SendCommand(EmulationThread::StepBackward);
+
 			if (ImGui::MenuItem("Close"))
 			{
-				Rom::filename = NULL;
-				Debugger::stepThrough = true;
-				Debugger::ResetSystem();
+				EmulationThread::Lock();
+				gb->rom.filename = NULL;
+				EmulationThread::Unlock();
+				EmulationThread::SendCommand(EmulationThread::Pause);
+				EmulationThread::SendCommand(EmulationThread::Reset);
 			}
 
 			if (ImGui::BeginMenu("Speed"))
 			{
-				int framerate = 60;
-				if (ImGui::MenuItem("1x (normal)")) Cpu::framerate = framerate;
-				if (ImGui::MenuItem("2x")) Cpu::framerate = (framerate / 2);
-				if (ImGui::MenuItem("3x")) Cpu::framerate = (framerate / 4);
-				if (ImGui::MenuItem("4x")) Cpu::framerate = (framerate / 4);
-				if (ImGui::MenuItem("5x")) Cpu::framerate = (framerate / 5);
-				if (ImGui::MenuItem("6x")) Cpu::framerate = (framerate / 6);
-				if (ImGui::MenuItem("7x")) Cpu::framerate = (framerate / 7);
-				if (ImGui::MenuItem("8x")) Cpu::framerate = (framerate / 8);
-				if (ImGui::MenuItem("9x")) Cpu::framerate = (framerate / 9);
-				if (ImGui::MenuItem("10x")) Cpu::framerate = (framerate / 10);
+				const int speeds[6] = {1, 2, 3, 4, 8, 16};
+				char label[16];
+
+				for (int i = 0; i < 6; i++)
+				{
+					sprintf(label, (speeds[i] == 1) ? "%dx (normal)" : "%dx", speeds[i]);
+
+					if (ImGui::MenuItem(label, NULL, !turbo && speed == speeds[i]))
+					{
+						EmulationThread::Lock();
+						speed = speeds[i];
+						turbo = false;
+						EmulationThread::Unlock();
+					}
+				}
+
+				// run as many frames as the host can manage
+				if (ImGui::MenuItem("Turbo", NULL, turbo))
+				{
+					EmulationThread::Lock();
+					turbo = !turbo;
+					EmulationThread::Unlock();
+				}
+
+				ImGui::EndMenu();
+			}
+
+			// only the ui changes these, so it can read them without the machine
+			if (ImGui::BeginMenu("Frame Skip"))
+			{
+				const int skips[6] = {0, 1, 2, 3, 5, 9};
+				char label[16];
+
+				for (int i = 0; i < 6; i++)
+				{
+					sprintf(label, (skips[i] == 0) ? "Off" : "%d", skips[i]);
+
+					if (ImGui::MenuItem(label, NULL, gb->lcd.frameSkip == skips[i]))
+					{
+						EmulationThread::Lock();
+						gb->lcd.frameSkip = skips[i];
+						EmulationThread::Unlock();
+					}
+				}
 
 				ImGui::EndMenu();
 			}
 
+			if (ImGui::MenuItem("Render", NULL, gb->lcd.renderEnabled))
+			{
+				EmulationThread::Lock();
+				gb->lcd.renderEnabled = !gb->lcd.renderEnabled;
+				EmulationThread::Unlock();
+			}
+
 			if (ImGui::MenuItem("Info"))
 			{
 				currentPopup = RomInfoPopup;
@@ -239,6 +405,8 @@ void Ui::Render()
 				ImGui::EndMenu();
 			}
 
+			if (ImGui::MenuItem("Frame Rate", NULL, showFps)) showFps = !showFps;
+
 			ImGui::EndMenu();
 		}
 
@@ -272,6 +440,8 @@ void Ui::Render()
 				ImGui::EndMenu();
 			}
 
+			if (ImGui::MenuItem("Stats", NULL, Debugger::showStats)) Debugger::showStats = !Debugger::showStats;
+
 			if (ImGui::MenuItem("Modify Registers/Flags", "ctrl+m"))
 			{
 				currentPopup = ModifyRegistersPopup;
@@ -281,38 +451,15 @@ void Ui::Render()
 			// step menu
 			if (ImGui::BeginMenu("Step Mode"))
 			{
-				if (ImGui::MenuItem("Enable")) Debugger::stepThrough = true;
-				if (ImGui::MenuItem("Disable")) Debugger::stepThrough = false;
+				if (ImGui::MenuItem("Enable")) EmulationThread::SendCommand(EmulationThread::Pause);
+				if (ImGui::MenuItem("Disable")) EmulationThread::SendCommand(EmulationThread::Resume);
 				ImGui::EndMenu();
 			}
 
-			if (ImGui::MenuItem("Step Forward", "ctrl+f"))
-			{
-				Cpu::Step();
-				Cpu::SaveState(true, Cpu::instructionsRan);
-			}
-
-			if (ImGui::MenuItem("Step Backward", "ctrl+b"))
-			{
-				if (Debugger::stepThrough)
-				{
-					if (Cpu::instructionsRan > 0)
-					{
-						Cpu::LoadState(true, Cpu::instructionsRan);
-						Cpu::instructionsRan -= 1;
-					}
-					else
-					{
-						Debugger::ResetSystem();
-					}
-				}
-			}
+			if (ImGui::MenuItem("Step Forward", "ctrl+f")) EmulationThread::SendCommand(EmulationThread::StepForward);
+			if (ImGui::MenuItem("Step Backward", "ctrl+b")) EmulationThread::SendCommand(EmulationThread::StepBackward);
 
-			if (ImGui::MenuItem("Run (No Break)", "ctrl+r"))
-			{
-				Debugger::stepThrough = false;
-				Debugger::stopAtBreakpoint = false;
-			}
+			if (ImGui::MenuItem("Run (No Break)", "ctrl+r")) EmulationThread::SendCommand(EmulationThread::ResumeNoBreak);
 
 			if (ImGui::MenuItem("Run To Break Point"))
 			{
@@ -322,16 +469,11 @@ void Ui::Render()
 
 			if (ImGui::MenuItem("Reset"))
 			{
-				Debugger::stepThrough = true;
-				Debugger::stopAtBreakpoint = false;
-				Debugger::ResetSystem(true);
+				EmulationThread::SendCommand(EmulationThread::PauseNoBreak);
+				EmulationThread::SendCommand(EmulationThread::Restart);
 			}
 
-			if (ImGui::MenuItem("Stop"))
-			{
-				Debugger::stepThrough = true;
-				Debugger::stopAtBreakpoint = false;
-			}
+			if (ImGui::MenuItem("Stop")) EmulationThread::SendCommand(EmulationThread::PauseNoBreak);
 			ImGui::EndMenu();
 		}
 
@@ -0,0 +1,280 @@
+/*
+ * DreamBoy - A Nintendo GameBoy Emulator
+ * Written in C/C++
+ * Author: Daniel Glover: http://github.com/dannyglover/
+ * License:  Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International License.
+ * http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * Copyright 2017 - Danny Glover. All rights reserved.
+ */
+
+// includes
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "includes/gameboy.h"
+#include "includes/log.h"
+#include "includes/workerPool.h"
+
+// init vars
+// indexed by the DIR_* and BTN_* key bits
+static const char *keyNames[8] = {"right", "left", "up", "down", "a", "b", "select", "start"};
+
+// responsible for pinning the calling thread to a single core
+static void PinToCore(int core)
+{
+#ifdef __linux__
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(core, &cpuSet);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#endif
+}
+
+// responsible for creating the pool (0 threads = one per core)
+WorkerPool::WorkerPool(int threadCount) : nextJob(0), threadCount(threadCount), wallSeconds(0)
+{
+	if (this->threadCount <= 0) this->threadCount = std::thread::hardware_concurrency();
+	if (this->threadCount <= 0) this->threadCount = 1;
+}
+
+// responsible for queueing a job
+bool WorkerPool::AddJob(const char *romPath, int frameBudget, const char *inputScript)
+{
+	Job job;
+	job.romPath = romPath;
+	job.inputScript = (inputScript != NULL) ? inputScript : "";
+	job.frameBudget = frameBudget;
+	job.framesRan = 0;
+	job.instructions = 0;
+	job.seconds = 0;
+	job.failed = false;
+
+	if (inputScript != NULL && !LoadInputScript(inputScript, job.inputEvents)) return false;
+
+	jobs.push_back(job);
+
+	return true;
+}
+
+// responsible for queueing every job in a job list ("rom.gb frames [script.txt]" per line)
+bool WorkerPool::AddJobList(const char *filePath)
+{
+	FILE *fp = fopen(filePath, "r");
+
+	if (fp == NULL)
+	{
+		Log::Critical("Failed to open job list: '%s'", filePath);
+		return false;
+	}
+
+	char line[1024];
+	char romPath[512];
+	char inputScript[512];
+	int frameBudget = 0;
+	bool result = true;
+
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		// drop the line ending, so it doesn't end up in the log
+		line[strcspn(line, "\r\n")] = '\0';
+
+		if (line[0] == '#' || line[0] == '\0') continue;
+
+		const int fields = sscanf(line, "%511s %d %511s", romPath, &frameBudget, inputScript);
+
+		if (fields < 2 || frameBudget <= 0)
+		{
+			Log::Critical("Invalid job: '%s'", line);
+			result = false;
+			continue;
+		}
+
+		if (!AddJob(romPath, frameBudget, (fields == 3) ? inputScript : NULL)) result = false;
+	}
+
+	fclose(fp);
+
+	return result;
+}
+
+// responsible for ordering input events by the frame they happen on
+static bool EventBefore(const WorkerPool::InputEvent &a, const WorkerPool::InputEvent &b)
+{
+	return (a.frame < b.frame);
+}
+
+// responsible for loading an input script ("frame key down|up" per line)
+bool WorkerPool::LoadInputScript(const char *filePath, std::vector<InputEvent> &events)
+{
+	FILE *fp = fopen(filePath, "r");
+
+	if (fp == NULL)
+	{
+		Log::Critical("Failed to open input script: '%s'", filePath);
+		return false;
+	}
+
+	char line[256];
+	char key[32];
+	char state[32];
+	int frame = 0;
+	bool result = true;
+
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		// drop the line ending, so it doesn't end up in the log
+		line[strcspn(line, "\r\n")] = '\0';
+
+		if (line[0] == '#' || line[0] == '\0') continue;
+
+		if (sscanf(line, "%d %31s %31s", &frame, key, state) != 3 || frame < 0)
+		{
+			Log::Critical("Invalid input event: '%s'", line);
+			result = false;
+			continue;
+		}
+
+		int bit = -1;
+
+		for (int i = 0; i < 8; i++)
+		{
+			if (strcmp(key, keyNames[i]) == 0) bit = i;
+		}
+
+		if (bit < 0)
+		{
+			Log::Critical("Invalid input key '%s' in: '%s'", key, line);
+			result = false;
+			continue;
+		}
+
+		if (strcmp(state, "down") != 0 && strcmp(state, "up") != 0)
+		{
+			Log::Critical("Invalid input state '%s' (expected down or up) in: '%s'", state, line);
+			result = false;
+			continue;
+		}
+
+		InputEvent event = {frame, (u8)bit, (strcmp(state, "down") == 0)};
+		events.push_back(event);
+	}
+
+	fclose(fp);
+
+	// a job only moves past an event once its frame comes round, so the events have to be in frame order (events on the same frame keep the order they were written in)
+	std::stable_sort(events.begin(), events.end(), EventBefore);
+
+	return result;
+}
+
+// responsible for running a single job to completion
+void WorkerPool::RunJob(Job &job)
+{
+	GameBoy *gameBoy = new GameBoy();
+	gameBoy->memory.serialOutput = NULL;
+	// nothing looks at the screen of a batch job
+	gameBoy->lcd.renderEnabled = false;
+
+	// rom loading logs to stdout, so keep it to one job at a time
+	loadMutex.lock();
+	const bool loaded = gameBoy->LoadRom(job.romPath.c_str());
+	loadMutex.unlock();
+
+	if (!loaded)
+	{
+		job.failed = true;
+		delete gameBoy;
+		return;
+	}
+
+	size_t nextEvent = 0;
+	const auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < job.frameBudget; i++)
+	{
+		while (nextEvent < job.inputEvents.size() && job.inputEvents[nextEvent].frame <= i)
+		{
+			const InputEvent &event = job.inputEvents[nextEvent++];
+			gameBoy->input.SetKey(event.key, event.pressed);
+		}
+
+		const bool finished = gameBoy->RunFrame();
+
+		job.instructions += gameBoy->cpu.instructionsRan;
+		gameBoy->cpu.instructionsRan = 0;
+
+		if (!finished)
+		{
+			job.failed = true;
+			break;
+		}
+
+		job.framesRan += 1;
+	}
+
+	job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	delete gameBoy;
+}
+
+// responsible for pulling jobs off the queue until it is empty
+void WorkerPool::Worker(int id)
+{
+	const int cores = std::thread::hardware_concurrency();
+
+	if (cores > 0) PinToCore(id % cores);
+
+	for (size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+	{
+		RunJob(jobs[i]);
+	}
+}
+
+// responsible for running every queued job
+void WorkerPool::Run()
+{
+	std::vector<std::thread> workers;
+	const int count = ((size_t)threadCount < jobs.size()) ? threadCount : jobs.size();
+	const auto start = std::chrono::steady_clock::now();
+
+	nextJob = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		workers.push_back(std::thread(&WorkerPool::Worker, this, i));
+	}
+
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+
+	wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// responsible for printing the per-job and aggregate results
+void WorkerPool::PrintReport()
+{
+	long long totalInstructions = 0;
+	long long totalFrames = 0;
+
+	for (size_t i = 0; i < jobs.size(); i++)
+	{
+		const Job &job = jobs[i];
+		const double fps = (job.seconds > 0) ? (job.framesRan / job.seconds) : 0;
+
+		totalInstructions += job.instructions;
+		totalFrames += job.framesRan;
+
+		Log::Print("%s%s: %d/%d frames in %.3f seconds (%.1f frames/sec, %lld instructions)", (job.failed) ? "[FAILED] " : "", job.romPath.c_str(), job.framesRan, job.frameBudget, job.seconds, fps, job.instructions);
+	}
+
+	if (wallSeconds <= 0) return;
+
+	Log::Print("Ran %d jobs on %d threads in %.3f seconds (%.1f frames/sec, %.0f instructions/sec)", (int)jobs.size(), threadCount, wallSeconds, totalFrames / wallSeconds, totalInstructions / wallSeconds);
+}